@@ -77,6 +77,9 @@ class BaseTest {
             return;
         }
 
+        // @Brief: Get number of iterations to run
+        size_t get_num_iteration() const { return num_iteration_; }
+
         // @Brief: Pre-declare some variables for deriviation, the
         // derived class may declare more if needed
     protected:
@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "checksum.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+// Upper bound on the number of threads used to hash a buffer. Hashing
+// is bound by memory bandwidth well before this many threads are busy
+static const uint32_t CHECKSUM_MAX_THREADS = 16;
+
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t Rotl64(uint64_t value, uint32_t bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t Read64(const uint8_t* ptr) {
+    uint64_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static inline uint32_t Read32(const uint8_t* ptr) {
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static inline uint64_t HashRound(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = Rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t HashMergeRound(uint64_t acc, uint64_t value) {
+    acc ^= HashRound(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+uint64_t ComputeHash64(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* ptr = (const uint8_t*)data;
+    const uint8_t* end = ptr + size;
+    uint64_t hash;
+
+    // Consume the buffer in stripes of 32 bytes. The four lanes
+    // carry no dependency on each other which lets the compiler
+    // keep them in flight together
+    if (size >= 32) {
+        uint64_t acc1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t acc2 = seed + PRIME64_2;
+        uint64_t acc3 = seed;
+        uint64_t acc4 = seed - PRIME64_1;
+        const uint8_t* limit = end - 32;
+        do {
+            acc1 = HashRound(acc1, Read64(ptr + 0));
+            acc2 = HashRound(acc2, Read64(ptr + 8));
+            acc3 = HashRound(acc3, Read64(ptr + 16));
+            acc4 = HashRound(acc4, Read64(ptr + 24));
+            ptr += 32;
+        } while (ptr <= limit);
+
+        hash = Rotl64(acc1, 1) + Rotl64(acc2, 7) + Rotl64(acc3, 12) + Rotl64(acc4, 18);
+        hash = HashMergeRound(hash, acc1);
+        hash = HashMergeRound(hash, acc2);
+        hash = HashMergeRound(hash, acc3);
+        hash = HashMergeRound(hash, acc4);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+    hash += (uint64_t)size;
+
+    // Consume the tail of the buffer
+    while ((ptr + 8) <= end) {
+        hash ^= HashRound(0, Read64(ptr));
+        hash = Rotl64(hash, 27) * PRIME64_1 + PRIME64_4;
+        ptr += 8;
+    }
+    if ((ptr + 4) <= end) {
+        hash ^= (uint64_t)Read32(ptr) * PRIME64_1;
+        hash = Rotl64(hash, 23) * PRIME64_2 + PRIME64_3;
+        ptr += 4;
+    }
+    while (ptr < end) {
+        hash ^= (*ptr) * PRIME64_5;
+        hash = Rotl64(hash, 11) * PRIME64_1;
+        ptr++;
+    }
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// @Brief: Return index of the first page at or after page_idx that
+// takes part in validation for the given stride
+static inline size_t NextSampledPage(size_t page_idx, uint32_t stride) {
+    return ((page_idx + stride - 1) / stride) * stride;
+}
+
+// @Brief: Compute the hash of one chunk of a buffer
+static uint64_t HashChunk(const uint8_t* base, size_t size, size_t chunk_idx, uint32_t stride) {
+    size_t begin = chunk_idx * CHECKSUM_CHUNK_SIZE;
+    size_t end = std::min(begin + CHECKSUM_CHUNK_SIZE, size);
+    if (stride <= 1) {
+        return ComputeHash64(base + begin, end - begin, chunk_idx);
+    }
+
+    // Hash each sampled page and fold the page hashes into one
+    uint32_t count = 0;
+    uint64_t page_hash[CHECKSUM_CHUNK_SIZE / CHECKSUM_PAGE_SIZE];
+    size_t page_idx = NextSampledPage(begin / CHECKSUM_PAGE_SIZE, stride);
+    for (; (page_idx * CHECKSUM_PAGE_SIZE) < end; page_idx += stride) {
+        size_t offset = page_idx * CHECKSUM_PAGE_SIZE;
+        size_t length = std::min((size_t)CHECKSUM_PAGE_SIZE, end - offset);
+        page_hash[count++] = ComputeHash64(base + offset, length, page_idx);
+    }
+    return ComputeHash64(page_hash, count * sizeof(uint64_t), chunk_idx);
+}
+
+// @Brief: Invoke func over ranges of chunks, fanning out to worker
+// threads when the buffer is large enough to amortize their launch
+template <typename Func>
+static void ParallelForChunks(size_t chunk_cnt, size_t size, Func func) {
+    uint32_t thread_cnt = 1;
+    if (size >= CHECKSUM_PARALLEL_THRESHOLD) {
+        thread_cnt = std::thread::hardware_concurrency();
+        thread_cnt = std::min(thread_cnt, CHECKSUM_MAX_THREADS);
+        thread_cnt = (uint32_t)std::min((size_t)thread_cnt, chunk_cnt);
+    }
+
+    if (thread_cnt <= 1) {
+        func(0, chunk_cnt);
+        return;
+    }
+
+    std::vector<std::thread> worker_list;
+    size_t per_thread = (chunk_cnt + thread_cnt - 1) / thread_cnt;
+    for (size_t first = 0; first < chunk_cnt; first += per_thread) {
+        size_t last = std::min(first + per_thread, chunk_cnt);
+        worker_list.push_back(std::thread(func, first, last));
+    }
+    for (uint32_t idx = 0; idx < worker_list.size(); idx++) {
+        worker_list[idx].join();
+    }
+}
+
+void ComputeChunkHashes(const void* data, size_t size, uint32_t stride,
+                        vector<uint64_t>& hash_list) {
+    const uint8_t* base = (const uint8_t*)data;
+    size_t chunk_cnt = (size + CHECKSUM_CHUNK_SIZE - 1) / CHECKSUM_CHUNK_SIZE;
+    hash_list.resize(chunk_cnt);
+
+    uint64_t* hash = hash_list.data();
+    ParallelForChunks(chunk_cnt, size, [=](size_t first, size_t last) {
+        for (size_t idx = first; idx < last; idx++) {
+            hash[idx] = HashChunk(base, size, idx, stride);
+        }
+    });
+}
+
+void FillSampledPages(void* data, size_t size, uint32_t stride, uint8_t value) {
+    uint8_t* base = (uint8_t*)data;
+    size_t chunk_cnt = (size + CHECKSUM_CHUNK_SIZE - 1) / CHECKSUM_CHUNK_SIZE;
+    ParallelForChunks(chunk_cnt, size, [=](size_t first, size_t last) {
+        size_t begin = first * CHECKSUM_CHUNK_SIZE;
+        size_t end = std::min(last * CHECKSUM_CHUNK_SIZE, size);
+        if (stride <= 1) {
+            std::memset(base + begin, value, end - begin);
+            return;
+        }
+        size_t page_idx = NextSampledPage(begin / CHECKSUM_PAGE_SIZE, stride);
+        for (; (page_idx * CHECKSUM_PAGE_SIZE) < end; page_idx += stride) {
+            size_t offset = page_idx * CHECKSUM_PAGE_SIZE;
+            std::memset(base + offset, value, std::min((size_t)CHECKSUM_PAGE_SIZE, end - offset));
+        }
+    });
+}
+
+// @Brief: Locate the first differing byte in the range [begin, end)
+static bool FindMismatchInRange(const uint8_t* expected, const uint8_t* actual, size_t begin,
+                                size_t end, size_t& offset) {
+    if (std::memcmp(expected + begin, actual + begin, end - begin) == 0) {
+        return false;
+    }
+    for (offset = begin; offset < end; offset++) {
+        if (expected[offset] != actual[offset]) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool FindFirstMismatch(const void* expected, const void* actual, size_t size, uint32_t stride,
+                       const vector<uint64_t>& expected_hash, const vector<uint64_t>& actual_hash,
+                       size_t& offset) {
+    const uint8_t* src = (const uint8_t*)expected;
+    const uint8_t* dst = (const uint8_t*)actual;
+
+    offset = 0;
+    if (expected_hash.size() != actual_hash.size()) {
+        return false;
+    }
+
+    // Only chunks whose hashes differ are compared byte by byte
+    size_t chunk_cnt = expected_hash.size();
+    for (size_t idx = 0; idx < chunk_cnt; idx++) {
+        if (expected_hash[idx] == actual_hash[idx]) {
+            continue;
+        }
+
+        size_t begin = idx * CHECKSUM_CHUNK_SIZE;
+        size_t end = std::min(begin + CHECKSUM_CHUNK_SIZE, size);
+        if (stride <= 1) {
+            if (FindMismatchInRange(src, dst, begin, end, offset)) {
+                return false;
+            }
+            continue;
+        }
+
+        size_t page_idx = NextSampledPage(begin / CHECKSUM_PAGE_SIZE, stride);
+        for (; (page_idx * CHECKSUM_PAGE_SIZE) < end; page_idx += stride) {
+            size_t page_begin = page_idx * CHECKSUM_PAGE_SIZE;
+            size_t page_end = std::min(page_begin + CHECKSUM_PAGE_SIZE, end);
+            if (FindMismatchInRange(src, dst, page_begin, page_end, offset)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_CHECKSUM_HPP
+#define ROC_BANDWIDTH_TEST_CHECKSUM_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+using namespace std;
+
+// Size of a page as seen by sampled validation
+#define CHECKSUM_PAGE_SIZE (4 * 1024)
+
+// Size of the unit of work whose hash is computed independently.
+// Must be a multiple of CHECKSUM_PAGE_SIZE
+#define CHECKSUM_CHUNK_SIZE (1024 * 1024)
+
+// Buffers smaller than this are hashed on the calling thread
+#define CHECKSUM_PARALLEL_THRESHOLD (4 * CHECKSUM_CHUNK_SIZE)
+
+// @Brief: Compute a 64-bit hash of a block of memory. Algorithm
+// follows xxHash64, running four independent accumulators
+uint64_t ComputeHash64(const void* data, size_t size, uint64_t seed);
+
+// @Brief: Compute the hash of every CHECKSUM_CHUNK_SIZE chunk of a
+// host visible buffer, using multiple threads for large buffers.
+// If stride is greater than one only every stride-th page of the
+// buffer contributes to the hash of its chunk
+void ComputeChunkHashes(const void* data, size_t size, uint32_t stride,
+                        vector<uint64_t>& hash_list);
+
+// @Brief: Fill the pages of a buffer that take part in validation
+// with the given byte value, using multiple threads for large buffers
+void FillSampledPages(void* data, size_t size, uint32_t stride, uint8_t value);
+
+// @Brief: Compare two lists of chunk hashes and if they differ locate
+// the first byte at which the two buffers differ. Returns true if
+// the two buffers match
+bool FindFirstMismatch(const void* expected, const void* actual, size_t size, uint32_t stride,
+                       const vector<uint64_t>& expected_hash, const vector<uint64_t>& actual_hash,
+                       size_t& offset);
+
+#endif    // ROC_BANDWIDTH_TEST_CHECKSUM_HPP
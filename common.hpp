@@ -69,6 +69,15 @@ using namespace std;
 
 #define ErrorCheck(x) error_check(x, __LINE__, __FILE__)
 
+// Error raised in place of ending the process by a test embedded
+// by the library interface. Errors other than those of HSA API
+// carry HSA_STATUS_ERROR
+typedef struct hsa_failure {
+        hsa_status_t status_;
+        int line_num_;
+        const char* file_;
+} hsa_failure_t;
+
 // @Brief: Check HSA API return value
 void error_check(hsa_status_t hsa_error_code, int line_num, const char* str);
 
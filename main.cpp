@@ -49,7 +49,10 @@
 using namespace std;
 
 int main(int argc, char** argv) {
-    // Default behavior is implemented as two runs
+    // Default behavior is implemented as a session of two
+    // scenarios, unidirectional and bidirectional copies
+    // among all devices, sharing Roc Runtime, topology and
+    // buffers
     uint32_t arg_cnt = argc;
     if (argc == 1) {
         argc++;
@@ -58,47 +61,26 @@ int main(int argc, char** argv) {
     }
 
     // Create the Bandwidth test object
-    RocmBandwidthTest bw_test1(argc, argv);
+    RocmBandwidthTest bw_test(argc, argv);
 
     // Initialize the Bandwidth test object
-    bw_test1.SetUp();
+    bw_test.SetUp();
 
     // Run the Bandwidth tests requested by user
-    bw_test1.Run();
+    // and display the time taken by various tests
+    bw_test.Run();
+    bw_test.Display();
 
-    // Return if user has not passed in any arguments
-    // Display the time taken by various tests
-    // Release the Bandwidth test object resources
-    if (arg_cnt != 1) {
-        bw_test1.Display();
-        bw_test1.Close();
-        return bw_test1.GetExitValue();
-    }
-
-    // Run the second iteration of copy requests
+    // Run the second scenario of default run
     if (arg_cnt == 1) {
-        optind = 1;
-        argv[1] = (char*)"-A";
+        scenario_t scenario;
+        scenario.mode_ = "all-bidir";
+        bw_test.SetUpScenario(scenario);
+        bw_test.Run();
+        bw_test.Display();
     }
 
-    // Create the Bandwidth test object
-    RocmBandwidthTest bw_test2(argc, argv);
-
-    // Initialize the Bandwidth test object
-    bw_test2.SetUp();
-
-    // Run the Bandwidth tests requested by user
-    bw_test2.Run();
-
-    // Display the time taken by various tests
-    // and then release associated resources
-    bw_test1.Display();
-    bw_test1.Close();
-
-    // Display the time taken by various tests
-    // and then release associated resources
-    bw_test2.Display();
-    bw_test2.Close();
-
-    return 0;
+    // Release the Bandwidth test object resources
+    bw_test.Close();
+    return bw_test.GetExitValue();
 }
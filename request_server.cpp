@@ -0,0 +1,230 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "request_server.hpp"
+#include "result_compare.hpp"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <sstream>
+
+RequestServer::RequestServer(const char* path, RequestHandler& handler)
+    : path_(path), handler_(handler) {
+    server_fd_ = -1;
+    request_cnt_ = 0;
+}
+
+RequestServer::~RequestServer() { Close(); }
+
+bool RequestServer::Open(std::string& error) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path_.size() >= sizeof(addr.sun_path)) {
+        error = "socket path is too long: " + path_;
+        return false;
+    }
+    std::strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    // Remove socket left behind by a previous daemon, unless that
+    // daemon is still accepting connections on it
+    struct stat info;
+    if ((stat(path_.c_str(), &info) == 0) && (S_ISSOCK(info.st_mode))) {
+        int probe_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = (probe_fd >= 0) &&
+                    (connect(probe_fd, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+        if (probe_fd >= 0) {
+            close(probe_fd);
+        }
+        if (live) {
+            error = "a daemon is already serving on " + path_;
+            return false;
+        }
+        unlink(path_.c_str());
+    }
+
+    server_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd_ < 0) {
+        error = std::string("unable to create socket: ") + strerror(errno);
+        return false;
+    }
+    if ((bind(server_fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0) ||
+        (listen(server_fd_, 8) != 0)) {
+        error = "unable to listen on " + path_ + ": " + strerror(errno);
+        close(server_fd_);
+        server_fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void RequestServer::Serve() {
+    while (server_fd_ >= 0) {
+        int client_fd = accept(server_fd_, NULL, NULL);
+        if (client_fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        bool status = ServeClient(client_fd);
+        close(client_fd);
+        if (status == false) {
+            return;
+        }
+    }
+}
+
+void RequestServer::Close() {
+    if (server_fd_ < 0) {
+        return;
+    }
+    close(server_fd_);
+    server_fd_ = -1;
+    unlink(path_.c_str());
+}
+
+// @brief: Write all of a response, returns false if client is gone
+static bool WriteResponse(int client_fd, const std::string& response) {
+    size_t offset = 0;
+    while (offset < response.size()) {
+        ssize_t count =
+            send(client_fd, response.data() + offset, response.size() - offset, MSG_NOSIGNAL);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        offset += count;
+    }
+    return true;
+}
+
+bool RequestServer::ServeClient(int client_fd) {
+    std::string pending;
+    char buffer[4096];
+    while (true) {
+        ssize_t count = recv(client_fd, buffer, sizeof(buffer), 0);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return true;
+        }
+        if (count == 0) {
+            return true;
+        }
+        pending.append(buffer, count);
+
+        // Handle every complete line received so far
+        size_t pos;
+        while ((pos = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, pos);
+            pending.erase(0, pos + 1);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            std::string response;
+            bool status = HandleRequest(line, response);
+            if ((WriteResponse(client_fd, response) == false) || (status == false)) {
+                return status;
+            }
+        }
+    }
+}
+
+bool RequestServer::HandleRequest(const std::string& line, std::string& response) {
+    request_cnt_++;
+    std::stringstream stream;
+    map<std::string, std::string> fields;
+    ParseJsonObject(line, fields);
+
+    // Requests other than running a benchmark
+    std::string request = fields["request"];
+    if ((request == "ping") || (request == "shutdown")) {
+        stream << "{\"status\": \"ok\", \"request\": " << request_cnt_ << ", \"records\": 0}"
+               << std::endl;
+        response = stream.str();
+        return (request == "ping");
+    }
+
+    // Requests are named by their sequence unless named by client
+    std::string error;
+    scenario_t scenario;
+    std::stringstream name;
+    name << "request" << request_cnt_;
+    scenario.name_ = name.str();
+    vector<result_record_t> record_list;
+    bool status = ((request.empty()) || (request == "run"))
+                      ? ParseScenarioFields(fields, scenario, error)
+                      : false;
+    if ((status == false) && (error.empty())) {
+        error = "unknown request " + request;
+    }
+    if (status) {
+        status = handler_.Handle(scenario, record_list, error);
+    }
+    if (status == false) {
+        stream << "{\"status\": \"error\", \"request\": " << request_cnt_ << ", \"error\": \""
+               << JsonEscape(error) << "\"}" << std::endl;
+        response = stream.str();
+        return true;
+    }
+
+    // Results are written as with -f ndjson
+    ResultSink* sink = CreateResultSink(SINK_FORMAT_NDJSON, stream);
+    for (uint32_t idx = 0; idx < record_list.size(); idx++) {
+        sink->Record(record_list[idx]);
+    }
+    sink->End();
+    delete sink;
+    stream << "{\"status\": \"ok\", \"request\": " << request_cnt_
+           << ", \"records\": " << record_list.size() << "}" << std::endl;
+    response = stream.str();
+    return true;
+}
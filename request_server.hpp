@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_REQUEST_SERVER_HPP
+#define ROC_BANDWIDTH_TEST_REQUEST_SERVER_HPP
+
+#include "result_sink.hpp"
+#include "scenario.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Runs the benchmark described by a request of a client
+class RequestHandler {
+    public:
+        virtual ~RequestHandler() {}
+
+        // @brief: Run the request, collecting its results. Returns
+        // false with a description of the error if it was not run
+        virtual bool Handle(const scenario_t& request, vector<result_record_t>& record_list,
+                            std::string& error) = 0;
+};
+
+// Serves requests of clients connecting over a local Unix socket.
+// Every request is a JSON object on a line of its own, holding the
+// settings of a scenario. Results of a request are written back as
+// JSON objects, one per line as with -f ndjson, followed by a status
+// line. Clients are served one at a time so requests never overlap
+class RequestServer {
+    public:
+        RequestServer(const char* path, RequestHandler& handler);
+
+        ~RequestServer();
+
+        // @brief: Bind and listen on the socket, returns false with
+        // a description of the error if socket cannot be opened
+        bool Open(std::string& error);
+
+        // @brief: Serve clients until one requests a shutdown
+        void Serve();
+
+        // @brief: Close and remove the socket
+        void Close();
+
+    private:
+        // @brief: Serve requests of a client until it disconnects,
+        // returns false if client requested a shutdown
+        bool ServeClient(int client_fd);
+
+        // @brief: Handle one request, writing its response
+        bool HandleRequest(const std::string& line, std::string& response);
+
+        std::string path_;
+        RequestHandler& handler_;
+        int server_fd_;
+        uint32_t request_cnt_;
+};
+
+#endif    // ROC_BANDWIDTH_TEST_REQUEST_SERVER_HPP
@@ -0,0 +1,230 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "result_compare.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+std::string GetRecordKey(const result_record_t& record) {
+    std::stringstream stream;
+    stream << record.mode_ << "|";
+    stream << record.src_.id_ << ((record.src_.fine_grained_) ? "|fine|" : "|coarse|");
+    stream << record.src_.pool_ord_ << "|";
+    stream << record.dst_.id_ << ((record.dst_.fine_grained_) ? "|fine|" : "|coarse|");
+    stream << record.dst_.pool_ord_ << "|";
+    stream << record.size_;
+    return stream.str();
+}
+
+// @brief: Read a JSON string starting at the opening quote,
+// returns position following the closing quote
+static size_t ReadJsonString(const std::string& line, size_t pos, std::string& value) {
+    value.clear();
+    for (pos++; pos < line.size(); pos++) {
+        char ch = line[pos];
+        if (ch == '"') {
+            return pos + 1;
+        }
+        if ((ch == '\\') && ((pos + 1) < line.size())) {
+            ch = line[++pos];
+            if ((ch == 'u') && ((pos + 4) < line.size())) {
+                ch = (char)strtoul(line.substr(pos + 1, 4).c_str(), NULL, 16);
+                pos += 4;
+            }
+        }
+        value += ch;
+    }
+    return pos;
+}
+
+void ParseJsonObject(const std::string& line, map<std::string, std::string>& fields) {
+    size_t pos = line.find('{');
+    if (pos == std::string::npos) {
+        return;
+    }
+
+    std::string key;
+    std::string value;
+    for (pos++; pos < line.size();) {
+        char ch = line[pos];
+        if ((ch == ' ') || (ch == '\t') || (ch == ',')) {
+            pos++;
+            continue;
+        }
+        if (ch != '"') {
+            return;
+        }
+
+        // Read key and locate its value
+        pos = ReadJsonString(line, pos, key);
+        pos = line.find(':', pos);
+        if (pos == std::string::npos) {
+            return;
+        }
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos) {
+            return;
+        }
+
+        if (line[pos] == '"') {
+            pos = ReadJsonString(line, pos, value);
+        } else if (line[pos] == '[') {
+            size_t end = line.find(']', pos);
+            if (end == std::string::npos) {
+                return;
+            }
+            value = line.substr(pos + 1, end - pos - 1);
+            pos = end + 1;
+        } else {
+            size_t end = line.find_first_of(",}", pos);
+            if (end == std::string::npos) {
+                return;
+            }
+            value = line.substr(pos, end - pos);
+            value.erase(value.find_last_not_of(" \t\r") + 1);
+            pos = end;
+        }
+        fields[key] = value;
+
+        if ((pos < line.size()) && (line[pos] == '}')) {
+            return;
+        }
+    }
+}
+
+static void ReadEndpoint(map<std::string, std::string>& fields, const std::string& prefix,
+                         result_endpoint_t& endpoint) {
+    endpoint.id_ = fields[prefix + "_id"];
+    endpoint.pool_idx_ = strtoul(fields[prefix + "_pool"].c_str(), NULL, 10);
+    endpoint.pool_ord_ = strtoul(fields[prefix + "_pool_ordinal"].c_str(), NULL, 10);
+    endpoint.dev_idx_ = strtoul(fields[prefix + "_device"].c_str(), NULL, 10);
+    endpoint.dev_type_ = fields[prefix + "_type"];
+    endpoint.name_ = fields[prefix + "_name"];
+    endpoint.bdf_ = fields[prefix + "_bdf"];
+    endpoint.uuid_ = fields[prefix + "_uuid"];
+    endpoint.fine_grained_ = (fields[prefix + "_fine_grained"] == "true");
+}
+
+bool LoadBaseline(const char* path, map<std::string, result_record_t>& baseline) {
+    std::ifstream file(path);
+    if (file.is_open() == false) {
+        return false;
+    }
+
+    // Every result record occupies a line of its own
+    std::string line;
+    while (std::getline(file, line)) {
+        map<std::string, std::string> fields;
+        ParseJsonObject(line, fields);
+        if (fields.find("mode") == fields.end()) {
+            continue;
+        }
+
+        result_record_t record;
+        record.mode_ = fields["mode"];
+        ReadEndpoint(fields, "src", record.src_);
+        ReadEndpoint(fields, "dst", record.dst_);
+        record.link_type_ = fields["link_type"];
+        record.link_hops_ = strtoul(fields["link_hops"].c_str(), NULL, 10);
+        record.link_weight_ = strtoul(fields["link_weight"].c_str(), NULL, 10);
+        record.size_ = strtoull(fields["size"].c_str(), NULL, 10);
+        record.avg_time_ = strtod(fields["avg_time_us"].c_str(), NULL) / 1e6;
+        record.min_time_ = strtod(fields["min_time_us"].c_str(), NULL) / 1e6;
+        record.std_time_ = strtod(fields["std_time_us"].c_str(), NULL) / 1e6;
+        record.sample_cnt_ = strtoul(fields["samples"].c_str(), NULL, 10);
+        record.avg_bandwidth_ = strtod(fields["avg_bw_gbps"].c_str(), NULL);
+        record.peak_bandwidth_ = strtod(fields["peak_bw_gbps"].c_str(), NULL);
+        record.validation_ = fields["validation"];
+        baseline[GetRecordKey(record)] = record;
+    }
+    return true;
+}
+
+// @brief: Critical value of Student's t distribution for a two
+// sided test at 95% confidence, Cornish-Fisher approximation
+static double GetCriticalT(double dof) {
+    const double z = 1.959964;
+    double z3 = z * z * z;
+    double z5 = z3 * z * z;
+    return z + ((z3 + z) / (4 * dof)) + (((5 * z5) + (16 * z3) + (3 * z)) / (96 * dof * dof));
+}
+
+void CompareRecord(const result_record_t& base, const result_record_t& curr, double tolerance,
+                   compare_record_t& result) {
+    result.curr_ = curr;
+    result.base_bandwidth_ = base.avg_bandwidth_;
+    result.delta_ = 0;
+    if (base.avg_bandwidth_ > 0) {
+        result.delta_ = ((curr.avg_bandwidth_ - base.avg_bandwidth_) / base.avg_bandwidth_) * 100;
+    }
+
+    // Welch t test of the copy times. Without spread in either
+    // sample any difference is treated as significant
+    double base_var = 0;
+    double curr_var = 0;
+    if (base.sample_cnt_ > 1) {
+        base_var = (base.std_time_ * base.std_time_) / base.sample_cnt_;
+    }
+    if (curr.sample_cnt_ > 1) {
+        curr_var = (curr.std_time_ * curr.std_time_) / curr.sample_cnt_;
+    }
+    result.t_stat_ = 0;
+    result.significant_ = true;
+    if ((base_var + curr_var) > 0) {
+        result.t_stat_ = (curr.avg_time_ - base.avg_time_) / sqrt(base_var + curr_var);
+        double dof = (base_var + curr_var) * (base_var + curr_var);
+        dof /= (((base_var * base_var) / std::max(base.sample_cnt_ - 1, 1u)) +
+                ((curr_var * curr_var) / std::max(curr.sample_cnt_ - 1, 1u)));
+        result.significant_ = (std::fabs(result.t_stat_) > GetCriticalT(dof));
+    }
+
+    result.status_ = COMPARE_OK;
+    if ((result.significant_) && (result.delta_ < -tolerance)) {
+        result.status_ = COMPARE_REGRESSED;
+    } else if ((result.significant_) && (result.delta_ > tolerance)) {
+        result.status_ = COMPARE_IMPROVED;
+    }
+}
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_RESULT_COMPARE_HPP
+#define ROC_BANDWIDTH_TEST_RESULT_COMPARE_HPP
+
+#include "result_sink.hpp"
+
+#include <map>
+#include <string>
+
+using namespace std;
+
+// Outcome of comparing a result against its baseline
+typedef enum Compare_Status {
+
+    COMPARE_OK = 0,
+    COMPARE_IMPROVED = 1,
+    COMPARE_REGRESSED = 2,
+    COMPARE_NO_BASELINE = 3,
+
+} Compare_Status;
+
+// Result of a run compared against its baseline. Delta is the change
+// of average bandwidth in percent, t_stat_ the Welch t statistic of
+// the difference between the copy times of the two runs
+typedef struct compare_record {
+        result_record_t curr_;
+        double base_bandwidth_;
+        double delta_;
+        double t_stat_;
+        bool significant_;
+        uint32_t status_;
+
+} compare_record_t;
+
+// @brief: Build a key identifying a result across runs. Uses the
+// mode, device identity, memory grain and ordinal of pool of both
+// end points and size
+std::string GetRecordKey(const result_record_t& record);
+
+// @brief: Parse a flat JSON object, one without nested objects, into
+// its fields. Values are kept in their text form, an array of numbers
+// as its elements separated by comma
+void ParseJsonObject(const std::string& line, map<std::string, std::string>& fields);
+
+// @brief: Load results of a previous run written in JSON or NDJSON
+// format, indexed by their key. Returns false if file is unreadable
+bool LoadBaseline(const char* path, map<std::string, result_record_t>& baseline);
+
+// @brief: Compare a result against its baseline. A difference of
+// average bandwidth counts only if it exceeds tolerance, given in
+// percent, and is statistically significant
+void CompareRecord(const result_record_t& base, const result_record_t& curr, double tolerance,
+                   compare_record_t& result);
+
+#endif    // ROC_BANDWIDTH_TEST_RESULT_COMPARE_HPP
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "result_sink.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+void ResultSink::WriteOut() {
+    out_ << buffer_.rdbuf();
+    out_.flush();
+    buffer_.str("");
+    buffer_.clear();
+}
+
+std::string JsonEscape(const std::string& value) {
+    std::stringstream stream;
+    for (uint32_t idx = 0; idx < value.size(); idx++) {
+        char ch = value[idx];
+        if ((ch == '"') || (ch == '\\')) {
+            stream << '\\' << ch;
+        } else if ((unsigned char)ch < 0x20) {
+            stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)ch
+                   << std::dec << std::setfill(' ');
+        } else {
+            stream << ch;
+        }
+    }
+    return stream.str();
+}
+
+// @brief: Quote a string for use as a CSV field if needed
+static std::string CsvEscape(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+        return value;
+    }
+    std::string quoted("\"");
+    for (uint32_t idx = 0; idx < value.size(); idx++) {
+        if (value[idx] == '"') {
+            quoted += '"';
+        }
+        quoted += value[idx];
+    }
+    quoted += '"';
+    return quoted;
+}
+
+// @brief: Write a number, JSON has no encoding for infinity or NaN
+static void WriteNumber(std::ostream& out, double value) {
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+static void WriteJsonEndpoint(std::ostream& out, const char* prefix,
+                              const result_endpoint_t& endpoint) {
+    out << "\"" << prefix << "_id\": \"" << JsonEscape(endpoint.id_) << "\", ";
+    out << "\"" << prefix << "_pool\": " << endpoint.pool_idx_ << ", ";
+    out << "\"" << prefix << "_pool_ordinal\": " << endpoint.pool_ord_ << ", ";
+    out << "\"" << prefix << "_device\": " << endpoint.dev_idx_ << ", ";
+    out << "\"" << prefix << "_type\": \"" << endpoint.dev_type_ << "\", ";
+    out << "\"" << prefix << "_name\": \"" << JsonEscape(endpoint.name_) << "\", ";
+    out << "\"" << prefix << "_bdf\": \"" << JsonEscape(endpoint.bdf_) << "\", ";
+    out << "\"" << prefix << "_uuid\": \"" << JsonEscape(endpoint.uuid_) << "\", ";
+    out << "\"" << prefix << "_fine_grained\": " << ((endpoint.fine_grained_) ? "true" : "false")
+        << ", ";
+}
+
+// @brief: Write a record as a JSON object on a single line
+static void WriteJsonRecord(std::ostream& out, const result_record_t& record) {
+    out << std::fixed << std::setprecision(6);
+    out << "{\"mode\": \"" << record.mode_ << "\", ";
+    WriteJsonEndpoint(out, "src", record.src_);
+    WriteJsonEndpoint(out, "dst", record.dst_);
+    out << "\"link_type\": \"" << record.link_type_ << "\", ";
+    out << "\"link_hops\": " << record.link_hops_ << ", ";
+    out << "\"link_weight\": " << record.link_weight_ << ", ";
+    out << "\"size\": " << record.size_ << ", ";
+    out << "\"avg_time_us\": ";
+    WriteNumber(out, record.avg_time_ * 1e6);
+    out << ", \"avg_bw_gbps\": ";
+    WriteNumber(out, record.avg_bandwidth_);
+    out << ", \"min_time_us\": ";
+    WriteNumber(out, record.min_time_ * 1e6);
+    out << ", \"peak_bw_gbps\": ";
+    WriteNumber(out, record.peak_bandwidth_);
+    out << ", \"std_time_us\": ";
+    WriteNumber(out, record.std_time_ * 1e6);
+    out << ", \"samples\": " << record.sample_cnt_;
+    out << ", \"validation\": \"" << record.validation_ << "\"}";
+}
+
+// Writes one JSON document holding a list of result records
+class JsonSink : public ResultSink {
+    public:
+        JsonSink(std::ostream& out) : ResultSink(out) { count_ = 0; }
+
+        virtual void Begin(const std::string& version, const std::string& command) {
+            buffer_ << "{" << std::endl;
+            buffer_ << "  \"version\": \"" << JsonEscape(version) << "\"," << std::endl;
+            buffer_ << "  \"command\": \"" << JsonEscape(command) << "\"," << std::endl;
+            buffer_ << "  \"results\": [";
+        }
+
+        virtual void Record(const result_record_t& record) {
+            buffer_ << ((count_ == 0) ? "" : ",") << std::endl << "    ";
+            WriteJsonRecord(buffer_, record);
+            count_++;
+        }
+
+        virtual void End() {
+            buffer_ << std::endl << "  ]" << std::endl << "}" << std::endl;
+            WriteOut();
+        }
+
+    private:
+        uint32_t count_;
+};
+
+// Streams one JSON object per line, written out on every flush
+class NdjsonSink : public ResultSink {
+    public:
+        NdjsonSink(std::ostream& out) : ResultSink(out) {}
+
+        virtual void Begin(const std::string& version, const std::string& command) {}
+
+        virtual void Record(const result_record_t& record) {
+            WriteJsonRecord(buffer_, record);
+            buffer_ << std::endl;
+        }
+
+        virtual void End() { WriteOut(); }
+
+        virtual void Flush() { WriteOut(); }
+};
+
+// Writes a header row followed by one row per record
+class CsvSink : public ResultSink {
+    public:
+        CsvSink(std::ostream& out) : ResultSink(out) {}
+
+        virtual void Begin(const std::string& version, const std::string& command) {
+            const char* prefix[] = {"src", "dst"};
+            buffer_ << "mode";
+            for (uint32_t idx = 0; idx < 2; idx++) {
+                buffer_ << "," << prefix[idx] << "_id," << prefix[idx] << "_pool," << prefix[idx]
+                        << "_pool_ordinal," << prefix[idx] << "_device," << prefix[idx]
+                        << "_type," << prefix[idx] << "_name," << prefix[idx] << "_bdf,"
+                        << prefix[idx] << "_uuid," << prefix[idx] << "_fine_grained";
+            }
+            buffer_ << ",link_type,link_hops,link_weight,size,avg_time_us,avg_bw_gbps,"
+                    << "min_time_us,peak_bw_gbps,std_time_us,samples,validation" << std::endl;
+        }
+
+        virtual void Record(const result_record_t& record) {
+            buffer_ << std::fixed << std::setprecision(6);
+            buffer_ << record.mode_;
+            WriteEndpoint(record.src_);
+            WriteEndpoint(record.dst_);
+            buffer_ << "," << record.link_type_ << "," << record.link_hops_ << ","
+                    << record.link_weight_ << "," << record.size_ << ","
+                    << (record.avg_time_ * 1e6) << "," << record.avg_bandwidth_ << ","
+                    << (record.min_time_ * 1e6) << "," << record.peak_bandwidth_ << ","
+                    << (record.std_time_ * 1e6) << "," << record.sample_cnt_ << ","
+                    << record.validation_ << std::endl;
+        }
+
+        virtual void End() { WriteOut(); }
+
+    private:
+        void WriteEndpoint(const result_endpoint_t& endpoint) {
+            buffer_ << "," << CsvEscape(endpoint.id_) << "," << endpoint.pool_idx_ << ","
+                    << endpoint.pool_ord_ << "," << endpoint.dev_idx_ << ","
+                    << endpoint.dev_type_ << "," << CsvEscape(endpoint.name_) << ","
+                    << CsvEscape(endpoint.bdf_) << "," << CsvEscape(endpoint.uuid_) << ","
+                    << ((endpoint.fine_grained_) ? 1 : 0);
+        }
+};
+
+// Writes records as rows of a fixed width table
+class TableSink : public ResultSink {
+    public:
+        TableSink(std::ostream& out) : ResultSink(out) {}
+
+        virtual void Begin(const std::string& version, const std::string& command) {
+            buffer_ << "RocmBandwidthTest Version: " << version << std::endl;
+            buffer_ << "Launch Command is: " << command << std::endl << std::endl;
+            buffer_.setf(ios::left);
+            const char* header[] = {"Mode",    "Src Pool", "Dst Pool",      "Src Dev",
+                                    "Dst Dev", "Link",     "Data Size(B)",  "Avg BW(GB/s)",
+                                    "Peak BW(GB/s)", "Validation"};
+            for (uint32_t idx = 0; idx < (sizeof(header) / sizeof(header[0])); idx++) {
+                buffer_ << std::setw((idx == 0) ? 20 : 15) << header[idx];
+            }
+            buffer_ << std::endl;
+        }
+
+        virtual void Record(const result_record_t& record) {
+            buffer_ << std::fixed << std::setprecision(3);
+            buffer_ << std::setw(20) << record.mode_;
+            buffer_ << std::setw(15) << record.src_.pool_idx_;
+            buffer_ << std::setw(15) << record.dst_.pool_idx_;
+            buffer_ << std::setw(15) << record.src_.dev_idx_;
+            buffer_ << std::setw(15) << record.dst_.dev_idx_;
+            buffer_ << std::setw(15) << record.link_type_;
+            buffer_ << std::setw(15) << record.size_;
+            buffer_ << std::setw(15) << record.avg_bandwidth_;
+            buffer_ << std::setw(15) << record.peak_bandwidth_;
+            buffer_ << std::setw(15) << record.validation_;
+            buffer_ << std::endl;
+        }
+
+        virtual void End() { WriteOut(); }
+};
+
+uint32_t GetSinkFormat(const char* name) {
+    if (std::strcmp(name, "table") == 0) {
+        return SINK_FORMAT_TABLE;
+    }
+    if (std::strcmp(name, "json") == 0) {
+        return SINK_FORMAT_JSON;
+    }
+    if (std::strcmp(name, "csv") == 0) {
+        return SINK_FORMAT_CSV;
+    }
+    if (std::strcmp(name, "ndjson") == 0) {
+        return SINK_FORMAT_NDJSON;
+    }
+    return SINK_FORMAT_INVALID;
+}
+
+ResultSink* CreateResultSink(uint32_t format, std::ostream& out) {
+    switch (format) {
+        case SINK_FORMAT_TABLE:
+            return new TableSink(out);
+        case SINK_FORMAT_JSON:
+            return new JsonSink(out);
+        case SINK_FORMAT_CSV:
+            return new CsvSink(out);
+        case SINK_FORMAT_NDJSON:
+            return new NdjsonSink(out);
+    }
+    return NULL;
+}
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_RESULT_SINK_HPP
+#define ROC_BANDWIDTH_TEST_RESULT_SINK_HPP
+
+#include <stdint.h>
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Describes one end point, memory pool and its device, of a copy
+typedef struct result_endpoint {
+        // Identifies the device across runs: UUID or BDF of a GPU,
+        // name and ordinal among CPUs of a CPU
+        std::string id_;
+
+        uint32_t pool_idx_;
+        uint32_t dev_idx_;
+
+        // Ordinal of the pool among pools of its device, telling
+        // apart pools of the same grain across runs
+        uint32_t pool_ord_;
+
+        std::string dev_type_;
+        std::string name_;
+        std::string bdf_;
+        std::string uuid_;
+        bool fine_grained_;
+
+} result_endpoint_t;
+
+// Describes the result of one copy size of one transaction
+typedef struct result_record {
+        // Kind of copy request e.g. unidir, bidir, all-unidir
+        std::string mode_;
+
+        result_endpoint_t src_;
+        result_endpoint_t dst_;
+
+        // Properties of link binding the two devices
+        std::string link_type_;
+        uint32_t link_hops_;
+        uint32_t link_weight_;
+
+        // Size of copy in bytes, times in seconds, bandwidth in GB/s.
+        // Standard deviation of copy time is over sample_cnt_ copies
+        uint64_t size_;
+        double avg_time_;
+        double min_time_;
+        double std_time_;
+        uint32_t sample_cnt_;
+        double avg_bandwidth_;
+        double peak_bandwidth_;
+
+        // Empty if copy was not validated, else PASS or FAIL per
+        // direction of copy separated by a slash
+        std::string validation_;
+
+} result_record_t;
+
+// Supported output formats of result sinks
+typedef enum Sink_Format {
+
+    SINK_FORMAT_TABLE = 0,
+    SINK_FORMAT_JSON = 1,
+    SINK_FORMAT_CSV = 2,
+    SINK_FORMAT_NDJSON = 3,
+    SINK_FORMAT_INVALID = 4,
+
+} Sink_Format;
+
+// Consumes results of a run and serializes them into a stream.
+// Output is accumulated in memory and written to the stream only
+// when the sink is flushed or ended
+class ResultSink {
+    public:
+        ResultSink(std::ostream& out) : out_(out) {}
+
+        virtual ~ResultSink() {}
+
+        // @brief: Start of results, version and command of the run
+        virtual void Begin(const std::string& version, const std::string& command) = 0;
+
+        // @brief: Add result of one copy size of a transaction
+        virtual void Record(const result_record_t& record) = 0;
+
+        // @brief: End of results
+        virtual void End() = 0;
+
+        // @brief: Write out results accumulated so far. Sinks that
+        // cannot emit partial documents write out only on End
+        virtual void Flush() {}
+
+    protected:
+        // @brief: Write accumulated output to the stream
+        void WriteOut();
+
+        std::ostream& out_;
+        std::stringstream buffer_;
+};
+
+// @brief: Escape a string for use as a JSON value
+std::string JsonEscape(const std::string& value);
+
+// @brief: Map name of a format to its value, SINK_FORMAT_INVALID if unknown
+uint32_t GetSinkFormat(const char* name);
+
+// @brief: Build a result sink of the given format writing into out
+ResultSink* CreateResultSink(uint32_t format, std::ostream& out);
+
+#endif    // ROC_BANDWIDTH_TEST_RESULT_SINK_HPP
@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rocm_bandwidth_api.h"
+#include "rocm_bandwidth_test.hpp"
+
+#include <cstring>
+
+// Session of the C interface, a bandwidth test object that is set
+// up without a command line and the results of its last run
+struct rbt_session {
+        rbt_session() : test_(1, argv_, true) {
+            argv_[0] = const_cast<char*>("rocm_bandwidth_test");
+            argv_[1] = NULL;
+        }
+
+        char* argv_[2];
+        RocmBandwidthTest test_;
+        size_t iter_cnt_;
+        vector<result_record_t> record_list_;
+};
+
+// @brief: Copy a string into a fixed size field, truncating it
+static void CopyField(char* field, size_t field_len, const std::string& value) {
+    std::strncpy(field, value.c_str(), field_len - 1);
+    field[field_len - 1] = '\0';
+}
+
+uint32_t rbt_get_api_version(void) { return RBT_API_VERSION; }
+
+rbt_status_t rbt_session_create(rbt_session_t* session) {
+    if (session == NULL) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    // Errors of the session, including invalid settings of environment
+    // variables, are returned to the client instead of ending its
+    // process, and copies run without printing progress
+    *session = NULL;
+    rbt_session_t handle = NULL;
+    try {
+        handle = new rbt_session();
+    } catch (const hsa_failure_t&) {
+        return RBT_STATUS_ERROR;
+    }
+    handle->test_.set_print_progress(false);
+    bool status = false;
+    try {
+        status = handle->test_.SetUpSession();
+    } catch (const hsa_failure_t&) {
+    }
+    if (status == false) {
+        delete handle;
+        return RBT_STATUS_ERROR;
+    }
+    handle->iter_cnt_ = handle->test_.get_num_iteration();
+    *session = handle;
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_session_destroy(rbt_session_t session) {
+    if (session == NULL) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    rbt_status_t status = RBT_STATUS_SUCCESS;
+    try {
+        session->test_.Close();
+    } catch (const hsa_failure_t&) {
+        status = RBT_STATUS_ERROR;
+    }
+    delete session;
+    return status;
+}
+
+rbt_status_t rbt_get_device_count(rbt_session_t session, uint32_t* count) {
+    if ((session == NULL) || (count == NULL)) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    *count = session->test_.GetAgentList().size();
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_device(rbt_session_t session, uint32_t index, rbt_device_t* device) {
+    if ((session == NULL) || (device == NULL) ||
+        (index >= session->test_.GetAgentList().size())) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    const agent_info_t& agent = session->test_.GetAgentList()[index];
+    device->index = agent.index_;
+    device->type = (agent.device_type_ == HSA_DEVICE_TYPE_CPU) ? RBT_DEVICE_TYPE_CPU
+                                                                : RBT_DEVICE_TYPE_GPU;
+    CopyField(device->name, sizeof(device->name), agent.name_);
+    CopyField(device->uuid, sizeof(device->uuid), agent.uuid_);
+    CopyField(device->bdf, sizeof(device->bdf), agent.bdf_id_);
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_pool_count(rbt_session_t session, uint32_t* count) {
+    if ((session == NULL) || (count == NULL)) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    *count = session->test_.GetPoolList().size();
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_pool(rbt_session_t session, uint32_t index, rbt_pool_t* pool) {
+    if ((session == NULL) || (pool == NULL) || (index >= session->test_.GetPoolList().size())) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    const pool_info_t& info = session->test_.GetPoolList()[index];
+    pool->index = info.index_;
+    pool->device_index = info.agent_index_;
+    pool->is_fine_grained = info.is_fine_grained_;
+    pool->is_kernarg = info.is_kernarg_;
+    pool->size = info.allocable_size_;
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_plan(rbt_session_t session, const rbt_plan_t* plan, uint32_t* trans_cnt) {
+    if ((session == NULL) || (plan == NULL) || (plan->mode == NULL)) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Plan is translated into a scenario, as read from a scenario file
+    scenario_t scenario;
+    scenario.mode_ = plan->mode;
+    for (uint32_t idx = 0; idx < plan->src_pool_cnt; idx++) {
+        scenario.src_list_.push_back(plan->src_pool_list[idx]);
+    }
+    for (uint32_t idx = 0; idx < plan->dst_pool_cnt; idx++) {
+        scenario.dst_list_.push_back(plan->dst_pool_list[idx]);
+    }
+    for (uint32_t idx = 0; idx < plan->pool_cnt; idx++) {
+        scenario.pool_list_.push_back(plan->pool_list[idx]);
+    }
+    for (uint32_t idx = 0; idx < plan->size_cnt; idx++) {
+        scenario.size_list_.push_back(plan->size_list[idx]);
+    }
+    scenario.validate_ = (plan->validate == RBT_SETTING_DEFAULT) ? 0 : plan->validate;
+
+    std::string error;
+    if ((plan->iterations == 0) || (plan->iterations < RBT_SETTING_DEFAULT) ||
+        (ValidateScenario(scenario, error) == false)) {
+        return RBT_STATUS_INVALID_PLAN;
+    }
+    session->record_list_.clear();
+    session->test_.set_num_iteration((plan->iterations == RBT_SETTING_DEFAULT)
+                                         ? session->iter_cnt_
+                                         : plan->iterations);
+    try {
+        if (session->test_.PlanScenario(scenario) == false) {
+            return RBT_STATUS_INVALID_PLAN;
+        }
+    } catch (const hsa_failure_t&) {
+        return RBT_STATUS_ERROR;
+    }
+    if (trans_cnt != NULL) {
+        *trans_cnt = session->test_.GetTransCount();
+    }
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_run(rbt_session_t session) {
+    if (session == NULL) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    try {
+        session->test_.Run();
+    } catch (const hsa_failure_t&) {
+        return RBT_STATUS_ERROR;
+    }
+    session->test_.GetResults(session->record_list_);
+
+    uint32_t record_cnt = session->record_list_.size();
+    for (uint32_t idx = 0; idx < record_cnt; idx++) {
+        if (session->record_list_[idx].validation_.find("FAIL") != std::string::npos) {
+            return RBT_STATUS_VALIDATION_FAILURE;
+        }
+    }
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_result_count(rbt_session_t session, uint32_t* count) {
+    if ((session == NULL) || (count == NULL)) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    *count = session->record_list_.size();
+    return RBT_STATUS_SUCCESS;
+}
+
+rbt_status_t rbt_get_result(rbt_session_t session, uint32_t index, rbt_result_t* result) {
+    if ((session == NULL) || (result == NULL) || (index >= session->record_list_.size())) {
+        return RBT_STATUS_INVALID_ARGUMENT;
+    }
+    const result_record_t& record = session->record_list_[index];
+    CopyField(result->mode, sizeof(result->mode), record.mode_);
+    result->src_pool = record.src_.pool_idx_;
+    result->src_device = record.src_.dev_idx_;
+    result->dst_pool = record.dst_.pool_idx_;
+    result->dst_device = record.dst_.dev_idx_;
+    CopyField(result->link_type, sizeof(result->link_type), record.link_type_);
+    result->link_hops = record.link_hops_;
+    result->link_weight = record.link_weight_;
+    result->size = record.size_;
+    result->samples = record.sample_cnt_;
+    result->avg_time_us = record.avg_time_ * 1000000;
+    result->min_time_us = record.min_time_ * 1000000;
+    result->std_time_us = record.std_time_ * 1000000;
+    result->avg_bw_gbps = record.avg_bandwidth_;
+    result->peak_bw_gbps = record.peak_bandwidth_;
+    result->validation = RBT_VALIDATION_NONE;
+    if (record.validation_.empty() == false) {
+        result->validation = (record.validation_.find("FAIL") != std::string::npos)
+                                 ? RBT_VALIDATION_FAIL
+                                 : RBT_VALIDATION_PASS;
+    }
+    return RBT_STATUS_SUCCESS;
+}
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_API_H
+#define ROC_BANDWIDTH_TEST_API_H
+
+#include <stdint.h>
+
+// C interface to the bandwidth test engine, allowing a client to
+// discover topology, plan copies, run them and retrieve results
+// in process. Structures are versioned by RBT_API_VERSION, which
+// is incremented whenever the layout of any of them changes
+
+#if defined(__GNUC__)
+#define RBT_API __attribute__((visibility("default")))
+#else
+#define RBT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RBT_API_VERSION 1
+
+// Value of a plan setting that takes the default of the session
+#define RBT_SETTING_DEFAULT (-1)
+
+// Status returned by functions of the interface. Errors of Roc
+// Runtime are returned as RBT_STATUS_ERROR, after which the session
+// can only be destroyed
+typedef enum rbt_status {
+
+    RBT_STATUS_SUCCESS = 0,
+    RBT_STATUS_ERROR = 1,
+    RBT_STATUS_INVALID_ARGUMENT = 2,
+    RBT_STATUS_INVALID_PLAN = 3,
+    RBT_STATUS_VALIDATION_FAILURE = 4,
+
+} rbt_status_t;
+
+typedef enum rbt_device_type {
+
+    RBT_DEVICE_TYPE_CPU = 0,
+    RBT_DEVICE_TYPE_GPU = 1,
+
+} rbt_device_type_t;
+
+typedef enum rbt_validation {
+
+    RBT_VALIDATION_NONE = 0,
+    RBT_VALIDATION_PASS = 1,
+    RBT_VALIDATION_FAIL = 2,
+
+} rbt_validation_t;
+
+// Opaque handle of a session, owning Roc Runtime and topology
+typedef struct rbt_session* rbt_session_t;
+
+// Describes a device discovered in the system
+typedef struct rbt_device {
+        uint32_t index;
+        rbt_device_type_t type;
+        char name[64];
+        char uuid[24];    // Empty for Cpu devices
+        char bdf[16];     // Empty for Cpu devices
+} rbt_device_t;
+
+// Describes a memory pool discovered in the system
+typedef struct rbt_pool {
+        uint32_t index;
+        uint32_t device_index;
+        uint32_t is_fine_grained;
+        uint32_t is_kernarg;
+        uint64_t size;    // Allocable size in bytes
+} rbt_pool_t;
+
+// Describes copies to run, as named by the modes of the command
+// line: unidir, bidir, all-unidir, all-bidir, concurrent-unidir or
+// concurrent-bidir. Unidir copies use lists of Src and Dst pools,
+// bidir and concurrent copies use list of pools. Sizes are in bytes
+// and default sizes are used if list is empty
+typedef struct rbt_plan {
+        const char* mode;
+        const uint32_t* src_pool_list;
+        uint32_t src_pool_cnt;
+        const uint32_t* dst_pool_list;
+        uint32_t dst_pool_cnt;
+        const uint32_t* pool_list;
+        uint32_t pool_cnt;
+        const uint64_t* size_list;
+        uint32_t size_cnt;
+        int32_t iterations;    // RBT_SETTING_DEFAULT or count
+        int32_t validate;      // RBT_SETTING_DEFAULT, 0 or 1
+} rbt_plan_t;
+
+// Describes the result of one copy size between a pair of pools
+typedef struct rbt_result {
+        char mode[24];
+        uint32_t src_pool;
+        uint32_t src_device;
+        uint32_t dst_pool;
+        uint32_t dst_device;
+        char link_type[8];    // XGMI, PCIe or N/A
+        uint32_t link_hops;
+        uint32_t link_weight;
+        uint64_t size;        // Bytes
+        uint32_t samples;
+        double avg_time_us;
+        double min_time_us;
+        double std_time_us;
+        double avg_bw_gbps;
+        double peak_bw_gbps;
+        rbt_validation_t validation;
+} rbt_result_t;
+
+// @brief: Return version of the interface the library implements
+RBT_API uint32_t rbt_get_api_version(void);
+
+// @brief: Initialize Roc Runtime and discover devices and pools.
+// Settings of environment variables apply to the session
+RBT_API rbt_status_t rbt_session_create(rbt_session_t* session);
+
+// @brief: Release buffers of the session and shut down Roc Runtime
+RBT_API rbt_status_t rbt_session_destroy(rbt_session_t session);
+
+// @brief: Return devices and pools discovered by the session
+RBT_API rbt_status_t rbt_get_device_count(rbt_session_t session, uint32_t* count);
+RBT_API rbt_status_t rbt_get_device(rbt_session_t session, uint32_t index, rbt_device_t* device);
+RBT_API rbt_status_t rbt_get_pool_count(rbt_session_t session, uint32_t* count);
+RBT_API rbt_status_t rbt_get_pool(rbt_session_t session, uint32_t index, rbt_pool_t* pool);
+
+// @brief: Plan copies to run, replacing copies and results of any
+// previous plan. Returns number of planned transactions
+RBT_API rbt_status_t rbt_plan(rbt_session_t session, const rbt_plan_t* plan,
+                              uint32_t* trans_cnt);
+
+// @brief: Run planned copies. Returns RBT_STATUS_VALIDATION_FAILURE
+// if any validated copy failed, results are available regardless
+RBT_API rbt_status_t rbt_run(rbt_session_t session);
+
+// @brief: Return results of the last run, one per copy size
+RBT_API rbt_status_t rbt_get_result_count(rbt_session_t session, uint32_t* count);
+RBT_API rbt_status_t rbt_get_result(rbt_session_t session, uint32_t index, rbt_result_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif    // ROC_BANDWIDTH_TEST_API_H
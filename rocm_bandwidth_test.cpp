@@ -42,6 +42,7 @@
 
 #include "rocm_bandwidth_test.hpp"
 
+#include "checksum.hpp"
 #include "common.hpp"
 
 #include <assert.h>
@@ -55,7 +56,6 @@
 #include <cstring>
 #include <limits>
 #include <sstream>
-#include <thread>
 
 // Initialize the variable used to capture validation failure
 const double RocmBandwidthTest::VALIDATE_COPY_OP_FAILURE = std::numeric_limits<double>::max();
@@ -72,7 +72,7 @@ const size_t RocmBandwidthTest::LATENCY_SIZE_LIST[] = {
     128,       256,       512,       1 * 1024,   2 * 1024,   4 * 1024,  8 * 1024,
     16 * 1024, 32 * 1024, 64 * 1024, 128 * 1024, 256 * 1024, 512 * 1024};
 
-uint32_t RocmBandwidthTest::GetIterationNum() { return (validate_) ? 1 : (num_iteration_ + 1); }
+uint32_t RocmBandwidthTest::GetIterationNum() { return (num_iteration_ + 1); }
 
 void RocmBandwidthTest::AcquireAccess(hsa_agent_t agent, void* ptr) {
     err_ = hsa_amd_agents_allow_access(1, &agent, NULL, ptr);
@@ -95,21 +95,62 @@ void RocmBandwidthTest::AcquirePoolAcceses(uint32_t src_dev_idx, hsa_agent_t src
     return;
 }
 
-void RocmBandwidthTest::InitializeSrcBuffer(size_t size, void* buf_cpy, uint32_t cpy_dev_idx,
-                                            hsa_agent_t cpy_agent) {
-    // Allocate host buffers and setup accessibility for copy operation
+void RocmBandwidthTest::ReserveInitBuffer(size_t size) {
+    // Size of copies can grow within a run, e.g. in ordered runs,
+    // scenarios or health checks, so buffer is grown to fit them
+    if (init_src_size_ >= size) {
+        return;
+    }
     if (init_src_ == NULL) {
-        err_ = hsa_amd_memory_pool_allocate(sys_pool_, size, 0, (void**)&init_src_);
-        ErrorCheck(err_);
-        long double* src_buf = (long double*)init_src_;
-        uint32_t count = (size / sizeof(long double));
-        for (uint32_t idx = 0; idx < count; idx++) {
-            src_buf[idx] = (init_) ? init_val_ : sin(idx);
-        }
         err_ = hsa_signal_create(0, 0, NULL, &init_signal_);
         ErrorCheck(err_);
+    } else {
+        // Queued snapshots are verified against the current buffer
+        validate_pipeline_.Drain();
+        hsa_amd_memory_pool_free(init_src_);
+        init_src_ = NULL;
+        init_src_size_ = 0;
     }
 
+    err_ = hsa_amd_memory_pool_allocate(sys_pool_, size, 0, (void**)&init_src_);
+    ErrorCheck(err_);
+    long double* src_buf = (long double*)init_src_;
+    size_t count = (size / sizeof(long double));
+    for (size_t idx = 0; idx < count; idx++) {
+        src_buf[idx] = (init_) ? init_val_ : sin(idx);
+    }
+    init_src_size_ = size;
+    init_hash_map_.clear();
+}
+
+void RocmBandwidthTest::ReleaseValidateBuffers() {
+    validate_pipeline_.Stop();
+    for (uint32_t idx = 0; idx < validate_buf_list_.size(); idx++) {
+        hsa_amd_memory_pool_free(validate_buf_list_[idx]);
+        hsa_signal_destroy(validate_sig_list_[idx]);
+    }
+    validate_buf_list_.clear();
+    validate_sig_list_.clear();
+    validate_fence_list_.clear();
+    validate_buf_size_ = 0;
+}
+
+void RocmBandwidthTest::ReleaseInitBuffers() {
+    ReleaseValidateBuffers();
+    if (init_src_ != NULL) {
+        hsa_signal_destroy(init_signal_);
+        hsa_amd_memory_pool_free(init_src_);
+        init_src_ = NULL;
+    }
+    init_src_size_ = 0;
+    init_hash_map_.clear();
+}
+
+void RocmBandwidthTest::InitializeSrcBuffer(size_t size, void* buf_cpy, uint32_t cpy_dev_idx,
+                                            hsa_agent_t cpy_agent) {
+    // Allocate host buffers and setup accessibility for copy operation
+    ReserveInitBuffer(size);
+
     // If copying agent is a CPU, use memcpy to initialize copy buffer
     hsa_device_type_t cpy_dev_type = agent_list_[cpy_dev_idx].device_type_;
     if (cpy_dev_type == HSA_DEVICE_TYPE_CPU) {
@@ -125,33 +166,137 @@ void RocmBandwidthTest::InitializeSrcBuffer(size_t size, void* buf_cpy, uint32_t
     return;
 }
 
-bool RocmBandwidthTest::ValidateDstBuffer(size_t max_size, size_t curr_size, void* buf_cpy,
-                                          uint32_t cpy_dev_idx, hsa_agent_t cpy_agent) {
-    // Allocate host buffers and setup accessibility for copy operation
-    if (validate_dst_ == NULL) {
-        err_ = hsa_amd_memory_pool_allocate(sys_pool_, max_size, 0, (void**)&validate_dst_);
-        ErrorCheck(err_);
+const vector<uint64_t>& RocmBandwidthTest::GetInitHashes(size_t size) {
+    // Source pattern does not change for the life of the test,
+    // so its hashes are computed once per copy size
+    map<size_t, vector<uint64_t>>::iterator it = init_hash_map_.find(size);
+    if (it != init_hash_map_.end()) {
+        return it->second;
+    }
+
+    vector<uint64_t>& hash_list = init_hash_map_[size];
+    ComputeChunkHashes(init_src_, size, validate_stride_, hash_list);
+    return hash_list;
+}
+
+void RocmBandwidthTest::SubmitDstValidation(size_t max_size, size_t curr_size, void* buf_cpy,
+                                            uint32_t cpy_dev_idx, hsa_agent_t cpy_agent,
+                                            uint32_t flow) {
+    // Allocate the rotating set of snapshot buffers on first use,
+    // allocating them again if a larger copy is requested
+    uint8_t fill_value = (uint8_t)(~(0x23));
+    if ((validate_pipeline_.IsStarted()) && (validate_buf_size_ < max_size)) {
+        ReleaseValidateBuffers();
+    }
+    if (validate_pipeline_.IsStarted() == false) {
+        for (uint32_t idx = 0; idx < VALIDATE_SNAPSHOT_CNT; idx++) {
+            void* buffer = NULL;
+            err_ = hsa_amd_memory_pool_allocate(sys_pool_, max_size, 0, &buffer);
+            ErrorCheck(err_);
+            FillSampledPages(buffer, max_size, 1, fill_value);
+            validate_buf_list_.push_back(buffer);
+            hsa_signal_t signal;
+            err_ = hsa_signal_create(1, 0, NULL, &signal);
+            ErrorCheck(err_);
+            validate_sig_list_.push_back(signal);
+        }
+        validate_buf_size_ = max_size;
+        validate_pipeline_.Start(VALIDATE_WORKER_CNT, validate_buf_list_, fill_value);
     }
 
-    // If Copy device is a Gpu setup buffer access
-    std::memset(validate_dst_, ~(0x23), curr_size);
+    validate_job_t job;
+    job.expected_ = init_src_;
+    job.expected_hash_ = &GetInitHashes(curr_size);
+    job.in_place_ = false;
+    job.wait_ready_ = false;
+
+    // Buffer of a Cpu device is verified in place. Buffer of a Gpu
+    // device is copied into a snapshot by the device without waiting,
+    // workers wait for the copy before verifying the snapshot
     hsa_device_type_t cpy_dev_type = agent_list_[cpy_dev_idx].device_type_;
-    if (cpy_dev_type == HSA_DEVICE_TYPE_GPU) {
-        AcquireAccess(cpy_agent, validate_dst_);
-        hsa_signal_store_relaxed(init_signal_, 1);
-        copy_buffer(validate_dst_, cpu_agent_, buf_cpy, cpy_agent, curr_size, init_signal_);
+    if (cpy_dev_type == HSA_DEVICE_TYPE_CPU) {
+        job.snapshot_ = buf_cpy;
+        job.in_place_ = true;
     } else {
-        // Copying device is a CPU, copy dst buffer
-        // into validation buffer
-        std::memcpy(validate_dst_, buf_cpy, curr_size);
+        // Blocks only if the workers fall behind the copies
+        void* snapshot = validate_pipeline_.AcquireBuffer();
+        uint32_t slot = 0;
+        while (validate_buf_list_[slot] != snapshot) {
+            slot++;
+        }
+        hsa_signal_t signal = validate_sig_list_[slot];
+        AcquireAccess(cpy_agent, snapshot);
+        hsa_signal_store_relaxed(signal, 1);
+        err_ = hsa_amd_memory_async_copy(snapshot, cpu_agent_, buf_cpy, cpy_agent, curr_size, 0,
+                                         NULL, signal);
+        ErrorCheck(err_);
+        validate_fence_list_.push_back(signal);
+        job.snapshot_ = snapshot;
+        job.ready_ = signal;
+        job.wait_ready_ = true;
+    }
+    job.size_ = curr_size;
+    job.stride_ = validate_stride_;
+    job.flow_ = flow;
+    validate_pipeline_.Submit(job);
+}
+
+void RocmBandwidthTest::FenceDstValidation() {
+    if (validate_pipeline_.IsStarted() == false) {
+        return;
     }
 
-    // Compare initialization buffer with validation buffer
-    err_ = (hsa_status_t)std::memcmp(init_src_, validate_dst_, curr_size);
-    if (err_ != HSA_STATUS_SUCCESS) {
-        exit_value_ = err_;
+    // Destination buffers must not be written until snapshot
+    // copies have read them and in place jobs verified them
+    WaitForCopyCompletion(validate_fence_list_);
+    validate_fence_list_.clear();
+    validate_pipeline_.WaitInPlace();
+}
+
+bool RocmBandwidthTest::CollectDstValidation(size_t curr_size, uint32_t flow) {
+    size_t offset = 0;
+    FenceDstValidation();
+    validate_pipeline_.Drain();
+    bool match = validate_pipeline_.GetResult(flow, offset);
+    if (match == false) {
+        // Clients of the library read the outcome from results
+        if (print_progress_) {
+            std::cout << std::endl;
+            std::cout << "Validation failed: first mismatch at byte offset " << offset
+                      << " of a " << curr_size << " byte copy" << std::endl;
+        }
+        exit_value_ = EXIT_VALIDATION_FAILURE;
+    }
+    return match;
+}
+
+void RocmBandwidthTest::error_check(hsa_status_t status, int line_num, const char* file) const {
+    if ((error_raise_) && (status != HSA_STATUS_SUCCESS) && (status != HSA_STATUS_INFO_BREAK)) {
+        hsa_failure_t failure;
+        failure.status_ = status;
+        failure.line_num_ = line_num;
+        failure.file_ = file;
+        throw failure;
+    }
+    ::error_check(status, line_num, file);
+}
+
+void RocmBandwidthTest::ExitOrRaise(int32_t exit_code) const {
+    if (error_raise_) {
+        hsa_failure_t failure;
+        failure.status_ = HSA_STATUS_ERROR;
+        failure.line_num_ = 0;
+        failure.file_ = NULL;
+        throw failure;
+    }
+    exit(exit_code);
+}
+
+void RocmBandwidthTest::PrintProgress() const {
+    if (print_progress_) {
+        printf(".");
+        fflush(stdout);
     }
-    return (err_ == HSA_STATUS_SUCCESS);
 }
 
 void RocmBandwidthTest::AllocateConcurrentCopyResources(
@@ -191,8 +336,7 @@ void RocmBandwidthTest::AllocateConcurrentCopyResources(
         // Allocate buffers and signal for forward copy operation
         AllocateCopyBuffers(max_size, buf_src, src_pool, buf_dst, dst_pool);
 
-        err_ = hsa_signal_create(1, 0, NULL, &signal);
-        ErrorCheck(err_);
+        signal = AcquireSignal();
 
         // Acquire access to destination buffers
         AcquirePoolAcceses(src_dev_idx, src_dev, buf_src, dst_dev_idx, dst_dev, buf_dst);
@@ -212,8 +356,7 @@ void RocmBandwidthTest::AllocateConcurrentCopyResources(
         // and signal for reverse direction as well
         if (bidir) {
             AllocateCopyBuffers(max_size, buf_src, dst_pool, buf_dst, src_pool);
-            err_ = hsa_signal_create(1, 0, NULL, &signal);
-            ErrorCheck(err_);
+            signal = AcquireSignal();
 
             // Acquire access to destination buffers
             AcquirePoolAcceses(dst_dev_idx, dst_dev, buf_src, src_dev_idx, src_dev, buf_dst);
@@ -235,28 +378,94 @@ void RocmBandwidthTest::AllocateConcurrentCopyResources(
 void RocmBandwidthTest::AllocateCopyBuffers(size_t size, void*& src, hsa_amd_memory_pool_t src_pool,
                                             void*& dst, hsa_amd_memory_pool_t dst_pool) {
     // Allocate buffers in src and dst pools for forward copy
-    err_ = hsa_amd_memory_pool_allocate(src_pool, size, 0, &src);
-    ErrorCheck(err_);
-    err_ = hsa_amd_memory_pool_allocate(dst_pool, size, 0, &dst);
+    src = AcquireBuffer(src_pool, size);
+    dst = AcquireBuffer(dst_pool, size);
+}
+
+void* RocmBandwidthTest::AcquireBuffer(hsa_amd_memory_pool_t pool, size_t size) {
+    // Reuse a released buffer of the same pool that is large enough.
+    // Buffers are not reused in validation mode so that data left
+    // by a previous copy cannot hide a failed copy
+    if (validate_ == false) {
+        for (uint32_t idx = 0; idx < buffer_cache_.size(); idx++) {
+            void* buffer = buffer_cache_[idx];
+            const cached_buffer_t& info = buffer_info_map_[buffer];
+            if ((info.pool_.handle == pool.handle) && (info.size_ >= size)) {
+                buffer_cache_.erase(buffer_cache_.begin() + idx);
+                return buffer;
+            }
+        }
+    }
+
+    void* buffer = NULL;
+    err_ = hsa_amd_memory_pool_allocate(pool, size, 0, &buffer);
     ErrorCheck(err_);
+    cached_buffer_t info;
+    info.pool_ = pool;
+    info.size_ = size;
+    buffer_info_map_[buffer] = info;
+    return buffer;
 }
 
 void RocmBandwidthTest::ReleaseBuffers(std::vector<void*>& buffer_list) {
+    // Keep released buffers for reuse, freeing the oldest
+    // ones once the cache is full
     for (uint32_t idx = 0; idx < buffer_list.size(); idx++) {
-        void* buffer = buffer_list[idx];
+        buffer_cache_.push_back(buffer_list[idx]);
+    }
+    while (buffer_cache_.size() > BUFFER_CACHE_CNT) {
+        void* buffer = buffer_cache_.front();
+        buffer_cache_.erase(buffer_cache_.begin());
+        buffer_info_map_.erase(buffer);
         err_ = hsa_amd_memory_pool_free(buffer);
         ErrorCheck(err_);
     }
 }
 
+void RocmBandwidthTest::FreeBufferCache() {
+    for (uint32_t idx = 0; idx < buffer_cache_.size(); idx++) {
+        hsa_amd_memory_pool_free(buffer_cache_[idx]);
+    }
+    buffer_cache_.clear();
+    buffer_info_map_.clear();
+}
+
+hsa_signal_t RocmBandwidthTest::AcquireSignal() {
+    // Reuse a released signal, resetting its value
+    hsa_signal_t signal;
+    if (signal_cache_.size() != 0) {
+        signal = signal_cache_.back();
+        signal_cache_.pop_back();
+        hsa_signal_store_relaxed(signal, 1);
+        return signal;
+    }
+
+    err_ = hsa_signal_create(1, 0, NULL, &signal);
+    ErrorCheck(err_);
+    return signal;
+}
+
 void RocmBandwidthTest::ReleaseSignals(std::vector<hsa_signal_t>& signal_list) {
+    // Keep released signals for reuse, destroying the
+    // ones that do not fit into the cache
     for (uint32_t idx = 0; idx < signal_list.size(); idx++) {
         hsa_signal_t signal = signal_list[idx];
+        if (signal_cache_.size() < SIGNAL_CACHE_CNT) {
+            signal_cache_.push_back(signal);
+            continue;
+        }
         err_ = hsa_signal_destroy(signal);
         ErrorCheck(err_);
     }
 }
 
+void RocmBandwidthTest::FreeSignalCache() {
+    for (uint32_t idx = 0; idx < signal_cache_.size(); idx++) {
+        hsa_signal_destroy(signal_cache_[idx]);
+    }
+    signal_cache_.clear();
+}
+
 double RocmBandwidthTest::GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd,
                                          hsa_signal_t signal_rev) {
     // Obtain time taken for forward copy
@@ -290,6 +499,21 @@ double RocmBandwidthTest::GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd,
     return copy_time;
 }
 
+double RocmBandwidthTest::GetGpuWindowTime(vector<hsa_signal_t>& signal_list,
+                                           uint32_t signal_cnt) {
+    // Window spans from earliest start to latest end of the copies
+    uint64_t start = std::numeric_limits<uint64_t>::max();
+    uint64_t end = 0;
+    for (uint32_t idx = 0; idx < signal_cnt; idx++) {
+        hsa_amd_profiling_async_copy_time_t async_time = {0};
+        err_ = hsa_amd_profiling_get_async_copy_time(signal_list[idx], &async_time);
+        ErrorCheck(err_);
+        start = min(start, async_time.start);
+        end = max(end, async_time.end);
+    }
+    return (double)(end - start);
+}
+
 void RocmBandwidthTest::WaitForCopyCompletion(vector<hsa_signal_t>& signal_list) {
     hsa_wait_state_t policy =
         (bw_blocking_run_ == NULL) ? HSA_WAIT_STATE_ACTIVE : HSA_WAIT_STATE_BLOCKED;
@@ -342,12 +566,11 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
 
     // Signa to trigger all copy requests to wait
     // until allowed to begin
-    hsa_signal_t sig_grp_start;
-    err_ = hsa_signal_create(1, 0, NULL, &sig_grp_start);
-    ErrorCheck(err_);
+    hsa_signal_t sig_grp_start = AcquireSignal();
 
     // Bind the number of iterations
     uint32_t iterations = GetIterationNum();
+    concurrent_window_time_.clear();
 
     // Iterate through the differnt buffer sizes to
     // compute the bandwidth as determined by copy
@@ -358,13 +581,18 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
             break;
         }
 
+        std::vector<double> window_time;
         std::vector<std::vector<double>> gpu_time_list(trans_cnt, std::vector<double>());
+        validate_pipeline_.ResetResults();
         for (uint32_t it = 0; it < iterations; it++) {
             if (it % 2) {
-                printf(".");
-                fflush(stdout);
+                PrintProgress();
             }
 
+            // Destination buffers of previous iteration must be
+            // read for validation before they are overwritten
+            FenceDstValidation();
+
             // Set group trigger signal
             hsa_signal_store_relaxed(sig_grp_start, 1);
 
@@ -399,6 +627,9 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
             // Wait for the copy operations to complete
             WaitForCopyCompletion(sig_list);
 
+            // Retrieve time window spanned by all copy operations
+            window_time.push_back(GetGpuWindowTime(sig_list, cpy_cnt));
+
             // Retrieve times for each copy operation
             hsa_signal_t signal_rev;
             for (uint32_t tidx = 0; tidx < trans_cnt; tidx++) {
@@ -409,6 +640,29 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
                 std::vector<double>& gpu_time = gpu_time_list[tidx];
                 gpu_time.push_back(temp);
             }
+
+            // Snapshot destination buffer of every copy, one flow
+            // per copy. They are verified in the background while
+            // next iteration of copies is running
+            if (validate_) {
+                for (uint32_t cpy_idx = 0; cpy_idx < cpy_cnt; cpy_idx++) {
+                    rsrc_idx = (cpy_idx * 2) + 1;
+                    SubmitDstValidation(max_size, curr_size, buf_list[rsrc_idx],
+                                        dev_idx_list[rsrc_idx], dev_list[rsrc_idx], cpy_idx);
+                }
+            }
+        }
+
+        // Collect the outcome of validating every iteration
+        if (validate_) {
+            for (uint32_t tidx = 0; tidx < trans_cnt; tidx++) {
+                async_trans_t& trans = trans_list[tidx];
+                uint32_t flow = (bidir) ? (tidx * 2) : (tidx);
+                trans.fwd_valid_.push_back(CollectDstValidation(curr_size, flow));
+                if (bidir) {
+                    trans.rev_valid_.push_back(CollectDstValidation(curr_size, flow + 1));
+                }
+            }
         }
 
         // Update time taken to copy a particular size
@@ -420,8 +674,11 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
             double mean_time = GetMeanTime(gpu_time);
             trans.gpu_min_time_.push_back(min_time);
             trans.gpu_avg_time_.push_back(mean_time);
+            trans.gpu_std_time_.push_back(GetStdDevTime(gpu_time, mean_time));
+            trans.gpu_max_time_.push_back(GetMaxTime(gpu_time));
             gpu_time.clear();
         }
+        concurrent_window_time_.push_back(GetMeanTime(window_time));
     }
 
     // Free up buffers and signal objects used in copy operation
@@ -430,209 +687,291 @@ void RocmBandwidthTest::RunConcurrentCopyBenchmark(bool bidir, vector<async_tran
     ReleaseBuffers(buf_list);
 }
 
-void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
-    // Bind if this transaction is bidirectional
-    bool bidir = trans.copy.bidir_;
-
-    // Initialize size of buffer to equal the largest element of allocation
+void RocmBandwidthTest::RunIsolatedCopies(vector<async_trans_t>& trans_list) {
+    // Copies are validated only when run concurrently
+    bool validate = validate_;
+    validate_ = false;
     size_t max_size = size_list_.back();
     uint32_t size_len = size_list_.size();
+    uint32_t iterations = GetIterationNum();
+    uint32_t trans_cnt = trans_list.size();
+    for (uint32_t tidx = 0; tidx < trans_cnt; tidx++) {
+        async_trans_t& trans = trans_list[tidx];
+        trans.isolated_time_.clear();
+        copy_resources_t res;
+        AcquireCopyResources(trans, max_size, res);
+        for (uint32_t idx = 0; idx < size_len; idx++) {
+            std::vector<double> cpu_time;
+            std::vector<double> gpu_time;
+            RunCopyIterations(trans, res, size_list_[idx], iterations, cpu_time, gpu_time);
+            trans.isolated_time_.push_back(GetMeanTime(gpu_time));
+        }
+        ReleaseCopyResources(res);
+    }
+    validate_ = validate;
+}
 
+void RocmBandwidthTest::AcquireCopyResources(const async_trans_t& trans, size_t max_size,
+                                             copy_resources_t& res) {
     // Bind to resources such as pool and agents that are involved
     // in both forward and reverse copy operations
-    void* buf_src_fwd;
-    void* buf_dst_fwd;
-    void* buf_src_rev;
-    void* buf_dst_rev;
-    hsa_signal_t signal_fwd;
-    hsa_signal_t signal_rev;
-    hsa_signal_t signal_start_bidir;
     uint32_t src_idx = trans.copy.src_idx_;
     uint32_t dst_idx = trans.copy.dst_idx_;
-    uint32_t src_dev_idx_fwd = pool_list_[src_idx].agent_index_;
-    uint32_t dst_dev_idx_fwd = pool_list_[dst_idx].agent_index_;
-    uint32_t src_dev_idx_rev = dst_dev_idx_fwd;
-    uint32_t dst_dev_idx_rev = src_dev_idx_fwd;
+    res.bidir_ = trans.copy.bidir_;
+    res.max_size_ = max_size;
+    res.src_dev_idx_fwd_ = pool_list_[src_idx].agent_index_;
+    res.dst_dev_idx_fwd_ = pool_list_[dst_idx].agent_index_;
+    res.src_dev_idx_rev_ = res.dst_dev_idx_fwd_;
+    res.dst_dev_idx_rev_ = res.src_dev_idx_fwd_;
     hsa_amd_memory_pool_t src_pool_fwd = trans.copy.src_pool_;
     hsa_amd_memory_pool_t dst_pool_fwd = trans.copy.dst_pool_;
     hsa_amd_memory_pool_t src_pool_rev = dst_pool_fwd;
     hsa_amd_memory_pool_t dst_pool_rev = src_pool_fwd;
-    hsa_agent_t src_agent_fwd = pool_list_[src_idx].owner_agent_;
-    hsa_agent_t dst_agent_fwd = pool_list_[dst_idx].owner_agent_;
-    hsa_agent_t src_agent_rev = dst_agent_fwd;
-    hsa_agent_t dst_agent_rev = src_agent_fwd;
-    std::vector<void*> buffer_list;
-    std::vector<hsa_signal_t> signal_list;
+    res.src_agent_fwd_ = pool_list_[src_idx].owner_agent_;
+    res.dst_agent_fwd_ = pool_list_[dst_idx].owner_agent_;
+    res.src_agent_rev_ = res.dst_agent_fwd_;
+    res.dst_agent_rev_ = res.src_agent_fwd_;
+    res.buffer_list_.clear();
+    res.signal_list_.clear();
+    res.pace_rate_ = 0;
+    res.pace_duty_ = false;
+    res.pace_gap_ = 0;
 
     // Allocate buffers for forward path of unidirectional
     // or bidirectional copy
-    AllocateCopyBuffers(max_size, buf_src_fwd, src_pool_fwd, buf_dst_fwd, dst_pool_fwd);
+    AllocateCopyBuffers(max_size, res.buf_src_fwd_, src_pool_fwd, res.buf_dst_fwd_, dst_pool_fwd);
 
-    // Create a signal to wait on copy operation
-    // @TODO: replace it with a signal pool call
-    err_ = hsa_signal_create(1, 0, NULL, &signal_fwd);
-    ErrorCheck(err_);
+    // Acquire a signal to wait on copy operation
+    res.signal_fwd_ = AcquireSignal();
 
     // Collect resources to be released later
-    signal_list.push_back(signal_fwd);
-    buffer_list.push_back(buf_src_fwd);
-    buffer_list.push_back(buf_dst_fwd);
+    res.signal_list_.push_back(res.signal_fwd_);
+    res.buffer_list_.push_back(res.buf_src_fwd_);
+    res.buffer_list_.push_back(res.buf_dst_fwd_);
 
     // Allocate buffers for reverse path of bidirectional copy
-    if (bidir) {
-        AllocateCopyBuffers(max_size, buf_src_rev, src_pool_rev, buf_dst_rev, dst_pool_rev);
-
-        // Create a signal to begin bidir copy operations
-        // @TODO: replace it with a signal pool call
-        err_ = hsa_signal_create(1, 0, NULL, &signal_rev);
-        ErrorCheck(err_);
-        err_ = hsa_signal_create(1, 0, NULL, &signal_start_bidir);
-        ErrorCheck(err_);
-
-        signal_list.push_back(signal_rev);
-        signal_list.push_back(signal_start_bidir);
-        buffer_list.push_back(buf_src_rev);
-        buffer_list.push_back(buf_dst_rev);
+    if (res.bidir_) {
+        AllocateCopyBuffers(max_size, res.buf_src_rev_, src_pool_rev, res.buf_dst_rev_,
+                            dst_pool_rev);
+
+        // Acquire signals to begin bidir copy operations
+        res.signal_rev_ = AcquireSignal();
+        res.signal_start_bidir_ = AcquireSignal();
+
+        res.signal_list_.push_back(res.signal_rev_);
+        res.signal_list_.push_back(res.signal_start_bidir_);
+        res.buffer_list_.push_back(res.buf_src_rev_);
+        res.buffer_list_.push_back(res.buf_dst_rev_);
     }
 
     // Initialize source buffers with data that could be verified
-    InitializeSrcBuffer(max_size, buf_src_fwd, src_dev_idx_fwd, src_agent_fwd);
-    if (bidir) {
-        InitializeSrcBuffer(max_size, buf_src_rev, src_dev_idx_rev, src_agent_rev);
+    InitializeSrcBuffer(max_size, res.buf_src_fwd_, res.src_dev_idx_fwd_, res.src_agent_fwd_);
+    if (res.bidir_) {
+        InitializeSrcBuffer(max_size, res.buf_src_rev_, res.src_dev_idx_rev_, res.src_agent_rev_);
     }
 
     // Setup access to destination buffers for
     // both unidirectional and bidirectional copies
-    AcquirePoolAcceses(src_dev_idx_fwd, src_agent_fwd, buf_src_fwd, dst_dev_idx_fwd, dst_agent_fwd,
-                       buf_dst_fwd);
-    if (bidir) {
-        AcquirePoolAcceses(src_dev_idx_rev, src_agent_rev, buf_src_rev, dst_dev_idx_rev,
-                           dst_agent_rev, buf_dst_rev);
+    AcquirePoolAcceses(res.src_dev_idx_fwd_, res.src_agent_fwd_, res.buf_src_fwd_,
+                       res.dst_dev_idx_fwd_, res.dst_agent_fwd_, res.buf_dst_fwd_);
+    if (res.bidir_) {
+        AcquirePoolAcceses(res.src_dev_idx_rev_, res.src_agent_rev_, res.buf_src_rev_,
+                           res.dst_dev_idx_rev_, res.dst_agent_rev_, res.buf_dst_rev_);
     }
+}
 
-    // Bind the number of iterations
-    uint32_t iterations = GetIterationNum();
+void RocmBandwidthTest::ReleaseCopyResources(copy_resources_t& res) {
+    // Free up buffers and signal objects used in copy operation
+    ReleaseSignals(res.signal_list_);
+    ReleaseBuffers(res.buffer_list_);
+    res.signal_list_.clear();
+    res.buffer_list_.clear();
+}
 
-    // Iterate through the differnt buffer sizes to
-    // compute the bandwidth as determined by copy
-    for (uint32_t idx = 0; idx < size_len; idx++) {
-        // This should not be happening
-        size_t curr_size = size_list_[idx];
-        if (curr_size > max_size) {
-            break;
+void RocmBandwidthTest::RunCopyIterations(const async_trans_t& trans, copy_resources_t& res,
+                                          size_t curr_size, uint32_t iterations,
+                                          vector<double>& cpu_time, vector<double>& gpu_time) {
+    bool bidir = res.bidir_;
+    ResetPacer(res);
+    for (uint32_t it = 0; it < iterations; it++) {
+        if (it % 2) {
+            PrintProgress();
         }
 
-        bool verify = true;
-        std::vector<double> cpu_time;
-        std::vector<double> gpu_time;
-        for (uint32_t it = 0; it < iterations; it++) {
-            if (it % 2) {
-                printf(".");
-                fflush(stdout);
-            }
+        hsa_signal_store_relaxed(res.signal_fwd_, 1);
+        if (bidir) {
+            hsa_signal_store_relaxed(res.signal_rev_, 1);
+            hsa_signal_store_relaxed(res.signal_start_bidir_, 1);
+        }
 
-            hsa_signal_store_relaxed(signal_fwd, 1);
-            if (bidir) {
-                hsa_signal_store_relaxed(signal_rev, 1);
-                hsa_signal_store_relaxed(signal_start_bidir, 1);
-            }
+        // Wait for credit to run the copy if copies are paced
+        WaitForPacer(res);
 
-            // Temporary code for testing
-            if (sleep_time_ > 0) {
-                std::this_thread::sleep_for(sleep_usecs_);
-            }
+        // Destination buffers of previous iteration must be
+        // read for validation before they are overwritten
+        FenceDstValidation();
+        std::chrono::time_point<std::chrono::steady_clock> copy_start =
+            std::chrono::steady_clock::now();
 
-            // Create a timer object and start it
-            if (print_cpu_time_) {
-                cpu_start_ = std::chrono::steady_clock::now();
-            }
+        // Create a timer object and start it
+        if (print_cpu_time_) {
+            cpu_start_ = std::chrono::steady_clock::now();
+        }
 
-            // Launch the copy operation
-            if (bidir == false) {
-                err_ = hsa_amd_memory_async_copy(buf_dst_fwd, dst_agent_fwd, buf_src_fwd,
-                                                 src_agent_fwd, curr_size, 0, NULL, signal_fwd);
-            } else {
-                err_ = hsa_amd_memory_async_copy(buf_dst_fwd, dst_agent_fwd, buf_src_fwd,
-                                                 src_agent_fwd, curr_size, 1, &signal_start_bidir,
-                                                 signal_fwd);
-            }
+        // Launch the copy operation
+        if (bidir == false) {
+            err_ = hsa_amd_memory_async_copy(res.buf_dst_fwd_, res.dst_agent_fwd_,
+                                             res.buf_src_fwd_, res.src_agent_fwd_, curr_size, 0,
+                                             NULL, res.signal_fwd_);
+        } else {
+            err_ = hsa_amd_memory_async_copy(res.buf_dst_fwd_, res.dst_agent_fwd_,
+                                             res.buf_src_fwd_, res.src_agent_fwd_, curr_size, 1,
+                                             &res.signal_start_bidir_, res.signal_fwd_);
+        }
+        ErrorCheck(err_);
+
+        // Launch reverse copy operation if it is bidirectional
+        if (bidir) {
+            err_ = hsa_amd_memory_async_copy(res.buf_dst_rev_, res.dst_agent_rev_,
+                                             res.buf_src_rev_, res.src_agent_rev_, curr_size, 1,
+                                             &res.signal_start_bidir_, res.signal_rev_);
             ErrorCheck(err_);
+        }
 
-            // Launch reverse copy operation if it is bidirectional
-            if (bidir) {
-                err_ = hsa_amd_memory_async_copy(buf_dst_rev, dst_agent_rev, buf_src_rev,
-                                                 src_agent_rev, curr_size, 1, &signal_start_bidir,
-                                                 signal_rev);
-                ErrorCheck(err_);
-            }
+        // Signal the bidir copies to begin
+        if (bidir) {
+            hsa_signal_store_relaxed(res.signal_start_bidir_, 0);
+        }
 
-            // Signal the bidir copies to begin
-            if (bidir) {
-                hsa_signal_store_relaxed(signal_start_bidir, 0);
-            }
+        WaitForCopyCompletion(res.signal_list_);
+        ChargePacer(res, (bidir) ? (curr_size * 2) : curr_size, copy_start);
 
-            WaitForCopyCompletion(signal_list);
+        // Stop the timer object and extract time taken
+        if (print_cpu_time_) {
+            cpu_end_ = std::chrono::steady_clock::now();
+            cpu_cp_time_ = cpu_end_ - cpu_start_;
+            uint64_t cpu_temp = cpu_cp_time_.count();
+            cpu_time.push_back(cpu_temp);
+        }
 
-            // Stop the timer object and extract time taken
-            if (print_cpu_time_) {
-                cpu_end_ = std::chrono::steady_clock::now();
-                cpu_cp_time_ = cpu_end_ - cpu_start_;
-                uint64_t cpu_temp = cpu_cp_time_.count();
-                cpu_time.push_back(cpu_temp);
+        // Collect time from the signal(s)
+        if (print_cpu_time_ == false) {
+            if (trans.copy.uses_gpu_) {
+                double temp = GetGpuCopyTime(bidir, res.signal_fwd_, res.signal_rev_);
+                gpu_time.push_back(temp);
             }
+        }
 
-            // Collect time from the signal(s)
-            if (print_cpu_time_ == false) {
-                if (trans.copy.uses_gpu_) {
-                    double temp = GetGpuCopyTime(bidir, signal_fwd, signal_rev);
-                    gpu_time.push_back(temp);
-                }
+        // Snapshots are verified in the background while
+        // next iteration of copy is running
+        if (validate_) {
+            SubmitDstValidation(res.max_size_, curr_size, res.buf_dst_fwd_, res.dst_dev_idx_fwd_,
+                                res.dst_agent_fwd_, 0);
+            if (bidir) {
+                SubmitDstValidation(res.max_size_, curr_size, res.buf_dst_rev_,
+                                    res.dst_dev_idx_rev_, res.dst_agent_rev_, 1);
             }
+        }
+    }
+}
 
-            if (validate_) {
-                verify = ValidateDstBuffer(max_size, curr_size, buf_dst_fwd, dst_dev_idx_fwd,
-                                           dst_agent_fwd);
-            }
+void RocmBandwidthTest::CollectCopyTime(async_trans_t& trans, vector<double>& cpu_time,
+                                        vector<double>& gpu_time) {
+    // Collecting Cpu time. Get min and mean copy
+    // times and collect them into Cpu time list
+    double min_time = 0;
+    double mean_time = 0;
+    if (print_cpu_time_) {
+        min_time = GetMinTime(cpu_time);
+        mean_time = GetMeanTime(cpu_time);
+        trans.cpu_min_time_.push_back(min_time);
+        trans.cpu_avg_time_.push_back(mean_time);
+        trans.cpu_std_time_.push_back(GetStdDevTime(cpu_time, mean_time));
+        trans.cpu_max_time_.push_back(GetMaxTime(cpu_time));
+    }
+
+    // Collecting Gpu time. Get min and mean copy
+    // times and collect them into Gpu time list
+    if (print_cpu_time_ == false) {
+        if (trans.copy.uses_gpu_) {
+            min_time = GetMinTime(gpu_time);
+            mean_time = GetMeanTime(gpu_time);
+            trans.gpu_min_time_.push_back(min_time);
+            trans.gpu_avg_time_.push_back(mean_time);
+            trans.gpu_std_time_.push_back(GetStdDevTime(gpu_time, mean_time));
+            trans.gpu_max_time_.push_back(GetMaxTime(gpu_time));
         }
+    }
+}
 
-        // Collecting Cpu time. Capture verify failures if any
-        // Get min and mean copy times and collect them into Cpu
-        // time list
-        double min_time = 0;
-        double mean_time = 0;
-        if (print_cpu_time_) {
-            min_time = (verify) ? GetMinTime(cpu_time) : VALIDATE_COPY_OP_FAILURE;
-            mean_time = (verify) ? GetMeanTime(cpu_time) : VALIDATE_COPY_OP_FAILURE;
-            trans.cpu_min_time_.push_back(min_time);
-            trans.cpu_avg_time_.push_back(mean_time);
+void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
+    // Initialize size of buffer to equal the largest element of allocation
+    size_t max_size = size_list_.back();
+    uint32_t size_len = size_list_.size();
+    copy_resources_t res;
+    AcquireCopyResources(trans, max_size, res);
+    BindPaceRate(trans, res);
+    trans.pace_achieved_.clear();
+
+    // Bind the number of iterations
+    uint32_t iterations = GetIterationNum();
+
+    // Iterate through the differnt buffer sizes to
+    // compute the bandwidth as determined by copy
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        // This should not be happening
+        size_t curr_size = size_list_[idx];
+        if (curr_size > max_size) {
+            break;
         }
 
-        // Collecting Gpu time. Capture verify failures if any
-        // Get min and mean copy times and collect them into Gpu
-        // time list
-        if (print_cpu_time_ == false) {
-            if (trans.copy.uses_gpu_) {
-                min_time = (verify) ? GetMinTime(gpu_time) : VALIDATE_COPY_OP_FAILURE;
-                mean_time = (verify) ? GetMeanTime(gpu_time) : VALIDATE_COPY_OP_FAILURE;
-                trans.gpu_min_time_.push_back(min_time);
-                trans.gpu_avg_time_.push_back(mean_time);
-            }
+        std::vector<double> cpu_time;
+        std::vector<double> gpu_time;
+        validate_pipeline_.ResetResults();
+        RunCopyIterations(trans, res, curr_size, iterations, cpu_time, gpu_time);
+        if (trans.pace_rate_ > 0) {
+            trans.pace_achieved_.push_back(GetPacedRate(res));
         }
-        verify = true;
 
-        // Clear the stack of cpu times
-        if (print_cpu_time_) {
-            cpu_time.clear();
+        // Collect the outcome of validating every iteration
+        if (validate_) {
+            trans.fwd_valid_.push_back(CollectDstValidation(curr_size, 0));
+            if (res.bidir_) {
+                trans.rev_valid_.push_back(CollectDstValidation(curr_size, 1));
+            }
         }
-        gpu_time.clear();
+        CollectCopyTime(trans, cpu_time, gpu_time);
     }
 
-    // Free up buffers and signal objects used in copy operation
-    ReleaseSignals(signal_list);
-    ReleaseBuffers(buffer_list);
+    ReleaseCopyResources(res);
 }
 
 void RocmBandwidthTest::Run() {
+    // Daemon runs requests of its clients until asked to stop
+    if (daemon_path_ != NULL) {
+        RunDaemon();
+        return;
+    }
+
+    if (result_sink_ != NULL) {
+        result_sink_->Begin(GetVersion(), GetLaunchCmd());
+    }
+
+    // Run the scenarios of scenario file, health check or user request
+    if (scenario_list_.size() != 0) {
+        RunScenarios();
+    } else if (health_budget_ > 0) {
+        RunHealthCheck();
+    } else {
+        RunTransList();
+    }
+
+    if (result_sink_ != NULL) {
+        result_sink_->End();
+    }
+}
+
+void RocmBandwidthTest::RunTransList() {
     // Enable profiling of Async Copy Activity
     if (print_cpu_time_ == false) {
         err_ = hsa_amd_profiling_async_copy_enable(true);
@@ -643,26 +982,85 @@ void RocmBandwidthTest::Run() {
         (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR)) {
         bool bidir = (req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR);
         RunConcurrentCopyBenchmark(bidir, trans_list_);
+        if (bw_isolated_ != NULL) {
+            RunIsolatedCopies(trans_list_);
+        }
         ComputeCopyTime(trans_list_);
+        ComputeConcurrentMetrics(trans_list_);
+        for (uint32_t idx = 0; idx < trans_list_.size(); idx++) {
+            EmitResults(trans_list_[idx]);
+        }
+        CompareBaseline();
+        err_ = hsa_amd_profiling_async_copy_enable(false);
+        ErrorCheck(err_);
+        return;
+    }
+
+    // Sizes are searched for knees of bandwidth if user has requested
+    if (search_pct_list_.size() != 0) {
+        RunSizeSearch();
+        if (print_cpu_time_ == false) {
+            err_ = hsa_amd_profiling_async_copy_enable(false);
+            ErrorCheck(err_);
+        }
+        return;
+    }
+
+    // Probes are timed under background load if user has requested
+    if (load_pair_.size() != 0) {
+        RunLatencyUnderLoad();
+        err_ = hsa_amd_profiling_async_copy_enable(false);
+        ErrorCheck(err_);
+        return;
+    }
+
+    // Small copies are kept in flight at queue depths if user has requested
+    if (queue_depth_list_.size() != 0) {
+        RunQueueDepthSweep();
+        err_ = hsa_amd_profiling_async_copy_enable(false);
+        ErrorCheck(err_);
+        return;
+    }
+
+    // Copies are run as concurrent streams if user has requested
+    if (stream_cnt_ != 0) {
+        RunStreamScaling();
+        CompareBaseline();
         err_ = hsa_amd_profiling_async_copy_enable(false);
         ErrorCheck(err_);
         return;
     }
 
+    // Copies are run by the order engine if user has requested
+    bool ordered = IsOrderedRun();
+    if (ordered) {
+        RunOrderedCopies();
+    }
+
     // Iterate through the list of transactions and execute them
     uint32_t trans_size = trans_list_.size();
     for (uint32_t idx = 0; idx < trans_size; idx++) {
         async_trans_t& trans = trans_list_[idx];
-        if ((trans.req_type_ == REQ_COPY_BIDIR) || (trans.req_type_ == REQ_COPY_UNIDIR) ||
-            (trans.req_type_ == REQ_COPY_ALL_BIDIR) || (trans.req_type_ == REQ_COPY_ALL_UNIDIR)) {
+        if (((trans.req_type_ == REQ_COPY_BIDIR) || (trans.req_type_ == REQ_COPY_UNIDIR) ||
+             (trans.req_type_ == REQ_COPY_ALL_BIDIR) || (trans.req_type_ == REQ_COPY_ALL_UNIDIR)) &&
+            (ordered == false)) {
             RunCopyBenchmark(trans);
             ComputeCopyTime(trans);
+            EmitResults(trans);
         }
         if ((trans.req_type_ == REQ_READ) || (trans.req_type_ == REQ_WRITE)) {
             RunIOBenchmark(trans);
         }
     }
 
+    // Fit model of latency and bandwidth if user has requested
+    if ((bw_fit_ != NULL) || (bw_fit_file_ != NULL)) {
+        FitLinkModels();
+        ExportLinkFits();
+    }
+
+    CompareBaseline();
+
     // Disable profiling of Async Copy Activity
     if (print_cpu_time_ == false) {
         err_ = hsa_amd_profiling_async_copy_enable(false);
@@ -671,13 +1069,24 @@ void RocmBandwidthTest::Run() {
 }
 
 void RocmBandwidthTest::Close() {
-    if (init_src_ != NULL) {
-        hsa_signal_destroy(init_signal_);
-        hsa_amd_memory_pool_free(init_src_);
+    ReleaseInitBuffers();
+    FreeBufferCache();
+    FreeSignalCache();
+
+    if (result_sink_ != NULL) {
+        delete result_sink_;
+        result_sink_ = NULL;
     }
+    if (sink_file_.is_open()) {
+        sink_file_.close();
+    }
+
+    // Keep pairs of agents discovered on first use for later runs
+    SaveTopologySnapshot();
 
-    if (validate_) {
-        hsa_amd_memory_pool_free(validate_dst_);
+    // Daemon serving requests with a stub did not initialize Roc Runtime
+    if ((daemon_path_ != NULL) && (bw_daemon_stub_ != NULL)) {
+        return;
     }
 
     hsa_status_t status = hsa_shut_down();
@@ -696,9 +1105,23 @@ void RocmBandwidthTest::Close() {
 //    Miscellaneous
 //
 void RocmBandwidthTest::SetUp() {
+    session_start_ = std::chrono::steady_clock::now();
+
     // Parse user arguments
     ParseArguments();
 
+    // Requests of daemon are set up as they are received
+    if (daemon_path_ != NULL) {
+        return;
+    }
+
+    // Scenarios of a scenario file are set up as they are run
+    if (scenario_list_.size() != 0) {
+        OpenResultSink();
+        LoadBaselineResults();
+        return;
+    }
+
     // Validate input parameters
     bool status = ValidateArguments();
     if (status == false) {
@@ -712,11 +1135,23 @@ void RocmBandwidthTest::SetUp() {
         PrintHelpScreen();
         exit(1);
     }
+
+    // Open sink to emit results into if user has requested one
+    OpenResultSink();
+
+    // Load results to compare against if user has requested
+    LoadBaselineResults();
+
+    // Print time spent discovering topology if user has requested
+    if (bw_setup_timing_ != NULL) {
+        PrintSetupTime();
+    }
 }
 
-RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
+RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv, bool error_raise) : BaseTest() {
     usr_argc_ = argc;
     usr_argv_ = argv;
+    error_raise_ = error_raise;
 
     pool_index_ = 0;
     cpu_index_ = -1;
@@ -745,11 +1180,23 @@ RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
     validate_ = false;
     print_cpu_time_ = false;
 
+    result_sink_ = NULL;
+    sink_path_ = NULL;
+    baseline_path_ = NULL;
+    scenario_path_ = NULL;
+    daemon_path_ = NULL;
+    health_budget_ = 0;
+    stream_cnt_ = 0;
+    grain_compare_ = false;
+    print_progress_ = true;
+    sink_format_ = SINK_FORMAT_INVALID;
+
     // Set initial value to 11.231926 in case
     // user does not have a preference
     init_val_ = 11.231926;
     init_src_ = NULL;
-    validate_dst_ = NULL;
+    init_src_size_ = 0;
+    validate_buf_size_ = 0;
 
     // Initialize version of the test
     version_.major_id = 2;
@@ -757,25 +1204,148 @@ RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
     version_.step_id = 0;
     version_.reserved = 0;
 
-    // Test impact of sleep, temp code
-    sleep_time_ = 0;
+    // Model fit to copy times, with a knee if user has requested
+    bw_fit_ = getenv("ROCM_BW_FIT");
+    bw_fit_file_ = getenv("ROCM_BW_FIT_FILE");
+    fit_knee_ = false;
+    if (bw_fit_ != NULL) {
+        std::string fit(bw_fit_);
+        if ((fit != "linear") && (fit != "knee")) {
+            std::cout << "Value of ROCM_BW_FIT must be linear or knee: " << fit << std::endl;
+            ExitOrRaise(1);
+        }
+        fit_knee_ = (fit == "knee");
+    }
+
+    // Rates at which copies are paced by a token bucket, or gap
+    // before every copy
+    bw_rate_ = getenv("ROCM_BW_RATE");
     bw_sleep_time_ = getenv("ROCM_BW_SLEEP_TIME");
-    if (bw_sleep_time_ != NULL) {
-        sleep_time_ = atoi(bw_sleep_time_);
-        if ((sleep_time_ < 0) || (sleep_time_ > 400000)) {
-            std::cout << "Unit of sleep time is defined as 10 microseconds" << std::endl;
-            std::cout << "An input value of 10 implies sleep time of 100 microseconds" << std::endl;
-            std::cout << "Value of ROCM_BW_SLEEP_TIME must be between [1, 400000]" << sleep_time_
+    BuildPaceList();
+
+    // Validate every page of a copy unless user asks for sampling
+    validate_stride_ = 1;
+    bw_validate_stride_ = getenv("ROCM_BW_VALIDATE_STRIDE");
+    if (bw_validate_stride_ != NULL) {
+        int32_t stride = atoi(bw_validate_stride_);
+        if (stride < 1) {
+            std::cout << "Value of ROCM_BW_VALIDATE_STRIDE must be positive: " << stride
                       << std::endl;
-            exit(1);
+            ExitOrRaise(1);
         }
-        sleep_time_ *= 10;
-        std::chrono::microseconds temp(sleep_time_);
-        sleep_usecs_ = temp;
+        validate_stride_ = stride;
     }
 
+    // Tolerate a drop of five percent in bandwidth unless user
+    // specifies otherwise when comparing against a baseline
+    regression_tol_ = 5.0;
+    bw_regression_tol_ = getenv("ROCM_BW_REGRESSION_TOL");
+    if (bw_regression_tol_ != NULL) {
+        regression_tol_ = atof(bw_regression_tol_);
+        if ((regression_tol_ < 0) || (regression_tol_ > 100)) {
+            std::cout << "Value of ROCM_BW_REGRESSION_TOL must be between [0, 100]: "
+                      << regression_tol_ << std::endl;
+            ExitOrRaise(1);
+        }
+    }
+
+    // Mark links whose copy times vary by more than five percent
+    // unless user specifies otherwise
+    cv_limit_ = 5.0;
+    bw_cv_limit_ = getenv("ROCM_BW_CV_LIMIT");
+    if (bw_cv_limit_ != NULL) {
+        cv_limit_ = atof(bw_cv_limit_);
+        if (cv_limit_ <= 0) {
+            std::cout << "Value of ROCM_BW_CV_LIMIT must be positive: " << cv_limit_ << std::endl;
+            ExitOrRaise(1);
+        }
+    }
+    bw_variation_ = getenv("ROCM_BW_VARIATION");
+
     bw_iter_cnt_ = getenv("ROCM_BW_ITER_CNT");
     bw_default_run_ = getenv("ROCM_BW_DEFAULT_RUN");
+    bw_topology_cache_ = getenv("ROCM_BW_TOPOLOGY_CACHE");
+    bw_topology_offline_ = getenv("ROCM_BW_TOPOLOGY_OFFLINE");
+    bw_setup_timing_ = getenv("ROCM_BW_SETUP_TIMING");
+
+    // Stub of Roc Runtime is built only into the program run by tests
+#ifdef RBT_DAEMON_STUB
+    bw_daemon_stub_ = getenv("ROCM_BW_DAEMON_STUB");
+#else
+    bw_daemon_stub_ = NULL;
+    if (getenv("ROCM_BW_DAEMON_STUB") != NULL) {
+        std::cout << "ROCM_BW_DAEMON_STUB is ignored, it applies only to test builds"
+                  << std::endl;
+    }
+#endif
+
+    bw_health_bw_ = getenv("ROCM_BW_HEALTH_BW");
+    bw_isolated_ = getenv("ROCM_BW_ISOLATED");
+
+    // Order in which copies are run, by default transactions one after
+    // another in a single round, sizes in ascending order
+    bw_order_ = getenv("ROCM_BW_ORDER");
+    bw_order_seed_ = getenv("ROCM_BW_ORDER_SEED");
+    bw_rounds_ = getenv("ROCM_BW_ROUNDS");
+    order_shuffle_ = false;
+    order_interleave_sizes_ = false;
+    order_interleave_rounds_ = false;
+    if (bw_order_ != NULL) {
+        std::stringstream stream(bw_order_);
+        std::string token;
+        while (std::getline(stream, token, ',')) {
+            if (token == "shuffle") {
+                order_shuffle_ = true;
+            } else if (token == "sizes") {
+                order_interleave_sizes_ = true;
+            } else if (token == "rounds") {
+                order_interleave_rounds_ = true;
+            } else {
+                std::cout << "Value of ROCM_BW_ORDER must be a list of shuffle, sizes and rounds: "
+                          << bw_order_ << std::endl;
+                ExitOrRaise(1);
+            }
+        }
+    }
+    order_seed_ = std::chrono::system_clock::now().time_since_epoch().count();
+    if (bw_order_seed_ != NULL) {
+        order_seed_ = strtoul(bw_order_seed_, NULL, 10);
+    }
+    round_cnt_ = (order_interleave_rounds_) ? 4 : 1;
+    if (bw_rounds_ != NULL) {
+        int32_t num = atoi(bw_rounds_);
+        if (num <= 0) {
+            std::cout << "Value of ROCM_BW_ROUNDS must be positive: " << num << std::endl;
+            ExitOrRaise(1);
+        }
+        round_cnt_ = num;
+    }
+
+    // Levels of background load in percent of full rate of link
+    bw_load_levels_ = getenv("ROCM_BW_LOAD_LEVELS");
+    if (bw_load_levels_ == NULL) {
+        load_level_list_ = {0, 25, 50, 75, 100};
+    } else {
+        std::stringstream stream(bw_load_levels_);
+        std::string token;
+        while (std::getline(stream, token, ',')) {
+            int32_t num = atoi(token.c_str());
+            if ((num < 0) || (num > 100)) {
+                std::cout << "Value of ROCM_BW_LOAD_LEVELS must be between [0, 100]: " << num
+                          << std::endl;
+                ExitOrRaise(1);
+            }
+            load_level_list_.push_back(num);
+        }
+    }
+
+    setup_time_.discovery_time_ = std::chrono::nanoseconds::zero();
+    setup_time_.access_time_ = std::chrono::nanoseconds::zero();
+    setup_time_.link_time_ = std::chrono::nanoseconds::zero();
+    setup_time_.access_cnt_ = 0;
+    setup_time_.link_cnt_ = 0;
+    topology_offline_ = false;
+    topology_dirty_ = false;
     bw_blocking_run_ = getenv("ROCR_BW_RUN_BLOCKING");
     skip_cpu_fine_grain_ = getenv("ROCM_SKIP_CPU_FINE_GRAINED_POOL");
     skip_gpu_coarse_grain_ = getenv("ROCM_SKIP_GPU_COARSE_GRAINED_POOL");
@@ -784,7 +1354,7 @@ RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv) : BaseTest() {
         int32_t num = atoi(bw_iter_cnt_);
         if (num < 0) {
             std::cout << "Value of ROCM_BW_ITER_CNT can't be negative: " << num << std::endl;
-            exit(1);
+            ExitOrRaise(1);
         }
         set_num_iteration(num);
     }
@@ -813,3 +1383,12 @@ std::string RocmBandwidthTest::GetVersion() const {
     stream << version_.step_id;
     return stream.str();
 }
+
+std::string RocmBandwidthTest::GetLaunchCmd() const {
+    std::stringstream stream;
+    stream << usr_argv_[0];
+    for (uint32_t idx = 1; idx < usr_argc_; idx++) {
+        stream << " " << usr_argv_[idx];
+    }
+    return stream.str();
+}
@@ -46,8 +46,15 @@
 #include "base_test.hpp"
 #include "common.hpp"
 #include "hsa/hsa.h"
+#include "result_compare.hpp"
+#include "result_sink.hpp"
+#include "scenario.hpp"
+#include "validate_pipeline.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <fstream>
+#include <map>
 #include <vector>
 
 using namespace std;
@@ -58,6 +65,11 @@ typedef struct agent_info {
             agent_ = agent;
             index_ = index;
             device_type_ = device_type;
+
+            // Cpu agents do not report UUID or BDF
+            name_[0] = '\0';
+            uuid_[0] = '\0';
+            bdf_id_[0] = '\0';
         }
 
         agent_info() {}
@@ -102,6 +114,96 @@ typedef struct pool_info {
 
 } pool_info_t;
 
+// Outcome of checking the health of a link
+typedef enum Health_Status {
+
+    HEALTH_PASS = 0,
+    HEALTH_FAIL = 1,
+    HEALTH_SKIPPED = 2,
+
+} Health_Status;
+
+// Plan and outcome of checking a transaction in health check mode.
+// Cost is the estimated time in seconds to run the planned copies
+typedef struct health_plan {
+        size_t size_;
+        uint32_t iter_cnt_;
+        double cost_;
+        double expected_bw_;
+        double bandwidth_;
+        uint32_t link_type_;
+        uint32_t status_;
+
+} health_plan_t;
+
+// Throughput of a transaction run as a number of concurrent streams,
+// each with its own buffers, per size of copy
+typedef struct stream_result {
+        uint32_t trans_idx_;
+        uint32_t stream_cnt_;
+        vector<double> total_bandwidth_;
+        vector<double> stream_bandwidth_;
+        vector<double> fairness_;
+
+} stream_result_t;
+
+// Rate and latency of small copies of a transaction kept in flight at
+// a queue depth. Latency is in microseconds, from issue of a copy to
+// its completion being observed by host
+typedef struct iops_result {
+        uint32_t trans_idx_;
+        uint32_t depth_;
+        size_t size_;
+        double copy_rate_;
+        double lat_p50_;
+        double lat_p90_;
+        double lat_p99_;
+        double lat_max_;
+
+} iops_result_t;
+
+// Latency of small probe copies of a transaction while background
+// copies load a link at a level in percent of its full rate. Latency
+// is in microseconds and bandwidth of background copies in GB/s
+typedef struct load_result {
+        uint32_t trans_idx_;
+        uint32_t level_;
+        double load_bandwidth_;
+        double lat_p50_;
+        double lat_p90_;
+        double lat_p99_;
+        double lat_max_;
+
+} load_result_t;
+
+// Latency plus size over bandwidth model of copy time of a transaction,
+// optionally with a knee above which a second segment applies. Latency
+// is in seconds, bandwidth in GB/s, knee and half bandwidth sizes are
+// sizes of a copy in bytes, residual is the root mean square of errors
+// relative to measured times
+typedef struct link_fit {
+        uint32_t trans_idx_;
+        double alpha_;
+        double beta_;
+        size_t knee_size_;
+        double knee_alpha_;
+        double knee_beta_;
+        double half_size_;
+        double residual_;
+
+} link_fit_t;
+
+// Peak bandwidth of a transaction over sizes of a coarse sweep and the
+// smallest size reaching each share of peak bandwidth
+typedef struct size_search {
+        uint32_t trans_idx_;
+        size_t max_size_;
+        double peak_bandwidth_;
+        vector<size_t> knee_size_;
+        vector<double> knee_bandwidth_;
+
+} size_search_t;
+
 // Used to print out topology info
 typedef struct agent_pool_info {
         agent_pool_info() {}
@@ -112,6 +214,24 @@ typedef struct agent_pool_info {
 
 } agent_pool_info_t;
 
+// Describes a buffer that can be reused by copy operations
+typedef struct cached_buffer {
+        hsa_amd_memory_pool_t pool_;
+        size_t size_;
+
+} cached_buffer_t;
+
+// Time spent discovering agents and pools, and access and
+// link properties of the pairs of agents that were discovered
+typedef struct setup_time {
+        std::chrono::nanoseconds discovery_time_;
+        std::chrono::nanoseconds access_time_;
+        std::chrono::nanoseconds link_time_;
+        uint32_t access_cnt_;
+        uint32_t link_cnt_;
+
+} setup_time_t;
+
 typedef struct async_trans {
         uint32_t req_type_;
         union {
@@ -144,6 +264,14 @@ typedef struct async_trans {
         // Gpu Min time
         vector<double> gpu_min_time_;
 
+        // Standard deviation of Cpu and Gpu copy times
+        vector<double> cpu_std_time_;
+        vector<double> gpu_std_time_;
+
+        // Max of Cpu and Gpu copy times
+        vector<double> cpu_max_time_;
+        vector<double> gpu_max_time_;
+
         // BenchMark's Average copy time and average bandwidth
         vector<double> avg_time_;
         vector<double> avg_bandwidth_;
@@ -152,9 +280,88 @@ typedef struct async_trans {
         vector<double> min_time_;
         vector<double> peak_bandwidth_;
 
-        async_trans(uint32_t req_type) { req_type_ = req_type; }
+        // BenchMark's standard deviation of copy time
+        vector<double> std_time_;
+
+        // BenchMark's Max copy time and worst case bandwidth
+        vector<double> max_time_;
+        vector<double> min_bandwidth_;
+
+        // Validation outcome per size of forward and reverse copies
+        vector<bool> fwd_valid_;
+        vector<bool> rev_valid_;
+
+        // Average Gpu copy time of copies run by themselves and the
+        // slowdown of concurrent copies against them, per size
+        vector<double> isolated_time_;
+        vector<double> slowdown_;
+
+        // Average copy time and bandwidth of every round of copies,
+        // indexed by size and round, if copies were run in rounds.
+        // Copy time is in units of the Cpu or Gpu timer
+        vector<double> round_time_;
+        vector<double> round_bandwidth_;
+
+        // Requested rate of paced copies, in GB/s or as a duty cycle,
+        // and achieved rate per size. Rate is zero if unpaced
+        double pace_rate_;
+        bool pace_duty_;
+        vector<double> pace_achieved_;
+
+        async_trans(uint32_t req_type) {
+            req_type_ = req_type;
+            pace_rate_ = 0;
+            pace_duty_ = false;
+        }
 } async_trans_t;
 
+// Resources bound to copies of a transaction, buffers being large
+// enough for the largest size of copy
+typedef struct copy_resources {
+        bool bidir_;
+        size_t max_size_;
+        void* buf_src_fwd_;
+        void* buf_dst_fwd_;
+        void* buf_src_rev_;
+        void* buf_dst_rev_;
+        hsa_signal_t signal_fwd_;
+        hsa_signal_t signal_rev_;
+        hsa_signal_t signal_start_bidir_;
+        uint32_t src_dev_idx_fwd_;
+        uint32_t dst_dev_idx_fwd_;
+        uint32_t src_dev_idx_rev_;
+        uint32_t dst_dev_idx_rev_;
+        hsa_agent_t src_agent_fwd_;
+        hsa_agent_t dst_agent_fwd_;
+        hsa_agent_t src_agent_rev_;
+        hsa_agent_t dst_agent_rev_;
+        vector<void*> buffer_list_;
+        vector<hsa_signal_t> signal_list_;
+
+        // Token bucket pacing copies, in bytes per second or busy
+        // seconds per second, and cost of copies charged to it. A
+        // copy costs the gap instead, if one is given
+        double pace_rate_;
+        bool pace_duty_;
+        double pace_gap_;
+        double pace_tokens_;
+        double pace_cost_;
+        std::chrono::time_point<std::chrono::steady_clock> pace_last_;
+        std::chrono::time_point<std::chrono::steady_clock> pace_start_;
+
+} copy_resources_t;
+
+// Rate at which copies from a pool to another are paced, applying
+// to copies among all pools if any_ is set
+typedef struct pace_spec {
+        bool any_;
+        uint32_t src_idx_;
+        uint32_t dst_idx_;
+        bool duty_;
+        double rate_;
+
+} pace_spec_t;
+
 typedef enum Request_Type {
 
     REQ_READ = 1,
@@ -174,8 +381,10 @@ typedef enum Request_Type {
 
 class RocmBandwidthTest : public BaseTest {
     public:
-        // @brief: Constructor for test case of RocmBandwidthTest
-        RocmBandwidthTest(int argc, char** argv);
+        // @brief: Constructor for test case of RocmBandwidthTest. A
+        // test embedded by the library raises errors as hsa_failure_t
+        // in place of ending the process
+        RocmBandwidthTest(int argc, char** argv, bool error_raise = false);
 
         // @brief: Destructor for test case of RocmBandwidthTest
         virtual ~RocmBandwidthTest();
@@ -192,22 +401,132 @@ class RocmBandwidthTest : public BaseTest {
         // @brief: Display the results
         virtual void Display() const;
 
+        // @brief: Set up another scenario to run in the session,
+        // sharing Roc Runtime, topology and buffers of the session
+        void SetUpScenario(const scenario_t& scenario);
+
+        // @brief: Initialize Roc Runtime and discover topology
+        // without parsing command line, used by embedding clients
+        bool SetUpSession();
+
+        // @brief: Build transactions of a scenario, returning
+        // false if scenario is invalid for the system
+        bool PlanScenario(const scenario_t& scenario);
+
+        // @brief: Return discovered devices and pools, number of
+        // planned transactions and results of the last run
+        const vector<agent_info_t>& GetAgentList() const { return agent_list_; }
+        const vector<pool_info_t>& GetPoolList() const { return pool_list_; }
+        uint32_t GetTransCount() const { return trans_list_.size(); }
+        void GetResults(vector<result_record_t>& record_list) const;
+
+        // @brief: Run a scenario requested by a client of the daemon,
+        // returning false if it is invalid for the system
+        bool RunRequest(const scenario_t& scenario, vector<result_record_t>& record_list);
+
         // @brief: Return exit value, useful in case of error
         int32_t GetExitValue() { return exit_value_; }
 
+        // @brief: Enable or disable progress printed while copies run,
+        // disabled by clients that embed the library
+        void set_print_progress(bool print) { print_progress_ = print; }
+
     private:
         // @brief: Print Help Menu Screen
         void PrintHelpScreen();
 
+        // @brief: Check HSA API return value, hiding the function of
+        // the same name so ErrorCheck raises errors if enabled
+        void error_check(hsa_status_t status, int line_num, const char* file) const;
+
+        // @brief: End the process with exit code, or raise an error
+        // if errors are raised in place of ending the process
+        void ExitOrRaise(int32_t exit_code) const;
+
         // @brief: Discover the topology of pools on Rocm Platform
         void DiscoverTopology();
 
         // @brief: Populate link properties for the set of agents
         void DiscoverLinkProps();
-        void BindLinkProps(uint32_t idx1, uint32_t idx2);
+        void BindLinkProps(uint32_t idx1, uint32_t idx2) const;
 
         // @brief: Populates the access matrix
+        void AllocateLinkMatrices();
         void PopulateAccessMatrix();
+        void BindAccess(uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
+
+        // @brief: Return access or link properties of a pair of
+        // agents, discovering them on first use
+        uint32_t GetAccess(uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
+        uint32_t GetLinkProp(uint32_t key, uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
+
+        // @brief: Print time spent discovering topology
+        void PrintSetupTime() const;
+
+        // @brief: Discard discovered topology so it can be discovered
+        // again with different filters on grain of pools
+        void ResetTopology();
+
+        // @brief: Run the transactions of current request or scenario
+        void RunTransList();
+
+        // @brief: Run every scenario of scenario file, reporting
+        // results of each as it completes
+        void RunScenarios();
+        void DisplaySessionTime() const;
+
+        // @brief: Save settings of session inherited by scenarios and
+        // bind those of a scenario
+        void SaveSessionSettings();
+        void BindScenarioSettings(const scenario_t& scenario);
+
+        // @brief: Plan copies of a transaction to fit a share of time
+        // budget of health check, estimating their cost from the type
+        // of link and size of copy
+        void PlanHealthCheck(const async_trans_t& trans, double share, health_plan_t& plan) const;
+
+        // @brief: Check every link within time budget, stopping early
+        // on a clear failure, and display pass or fail per link
+        void RunHealthCheck();
+        void DisplayHealthCheck() const;
+
+        // @brief: Run copies of every transaction as one up to the
+        // requested number of concurrent streams, and display total
+        // and per stream throughput for each number of streams
+        void RunStreamScaling();
+        void DisplayStreamResults() const;
+
+        // @brief: Keep small copies of every transaction in flight at
+        // each queue depth, rolling over a pool of signals, and display
+        // copies per second and latency percentiles
+        void RunQueueDepthSweep();
+        void RunQueueDepthCopies(copy_resources_t& res, uint32_t depth, size_t size,
+                                 iops_result_t& result);
+        void DisplayQueueDepthResults() const;
+
+        // @brief: Time small probe copies of every transaction while
+        // background copies load a link at each level, and display
+        // probe latency percentiles per level
+        void RunLatencyUnderLoad();
+        void RunBackgroundLoad(copy_resources_t& res, double duty, std::atomic<bool>& stop,
+                               std::atomic<bool>& started, uint64_t& byte_cnt,
+                               hsa_status_t& status);
+        void DisplayLoadResults() const;
+
+        // @brief: Serve benchmark requests of clients over a local
+        // Unix socket until one of them requests a shutdown
+        void RunDaemon();
+
+        // @brief: Build topology and results of copies without Roc
+        // Runtime, used by a daemon serving requests with a stub
+        void BuildStubTopology();
+        void RunStubTransList();
+
+        // @brief: Save or load agents, pools and link properties
+        // to or from a snapshot keyed by fingerprint of hardware
+        uint64_t GetTopologyFingerprint() const;
+        void SaveTopologySnapshot() const;
+        bool LoadTopologySnapshot(bool offline);
 
         // @brief: Print topology info
         void PrintTopology();
@@ -239,9 +558,36 @@ class RocmBandwidthTest : public BaseTest {
         // @brief: Run copy requests of users
         void RunCopyBenchmark(async_trans_t& trans);
 
+        // @brief: Bind buffers and signals of copies of a transaction,
+        // run iterations of copies of a size and collect their times
+        void AcquireCopyResources(const async_trans_t& trans, size_t max_size,
+                                  copy_resources_t& res);
+        void ReleaseCopyResources(copy_resources_t& res);
+        void RunCopyIterations(const async_trans_t& trans, copy_resources_t& res,
+                               size_t curr_size, uint32_t iterations, vector<double>& cpu_time,
+                               vector<double>& gpu_time);
+        void CollectCopyTime(async_trans_t& trans, vector<double>& cpu_time,
+                             vector<double>& gpu_time);
+
+        // @brief: Print a mark of progress if it is enabled
+        void PrintProgress() const;
+
+        // @brief: Run copies of transactions in the order of execution
+        // order engine, in units of one size and round of a transaction,
+        // and display results of every round
+        bool IsOrderedRun() const;
+        void RunOrderedCopies();
+        void DisplayRoundResults() const;
+
         // @brief: Run copy requests of users
         void RunConcurrentCopyBenchmark(bool bidir, vector<async_trans_t>& trans_list);
 
+        // @brief: Run each copy of concurrent requests by itself, and
+        // compute aggregate bandwidth, fairness and slowdown of copies
+        void RunIsolatedCopies(vector<async_trans_t>& trans_list);
+        void ComputeConcurrentMetrics(vector<async_trans_t>& trans_list);
+        void DisplayConcurrentMetrics() const;
+
         // @brief: Get iteration number
         uint32_t GetIterationNum();
 
@@ -251,15 +597,99 @@ class RocmBandwidthTest : public BaseTest {
         // @brief: Get the min copy time
         double GetMinTime(vector<double>& vec);
 
+        // @brief: Get the max copy time, called after the mean copy
+        // time so the same outlier is left out
+        double GetMaxTime(vector<double>& vec);
+
+        // @brief: Get the standard deviation of copy times, computed
+        // over the same samples as the mean copy time
+        double GetStdDevTime(vector<double>& vec, double mean);
+
+        // @brief: Pace copies of a transaction by a token bucket,
+        // waiting for credit before a copy and charging its cost after
+        void BuildPaceList();
+        void BindPaceRate(async_trans_t& trans, copy_resources_t& res);
+        void ResetPacer(copy_resources_t& res);
+        void WaitForPacer(copy_resources_t& res);
+        void ChargePacer(copy_resources_t& res, size_t size,
+                         std::chrono::time_point<std::chrono::steady_clock> copy_start);
+        double GetPacedRate(copy_resources_t& res);
+        void DisplayPacingResults() const;
+
+        // @brief: Search sizes of every transaction for the smallest
+        // one reaching shares of peak bandwidth, by a coarse sweep of
+        // sizes followed by bisection to a byte
+        void RunSizeSearch();
+        size_t GetCopyDataSize(const async_trans_t& trans, size_t size) const;
+        double MeasureCopyBandwidth(const async_trans_t& trans, copy_resources_t& res, size_t size);
+        void DisplaySizeSearch() const;
+
+        // @brief: Fit a model of latency and bandwidth to copy times
+        // of every transaction, export the fits and display them
+        void FitLinkModels();
+        void ExportLinkFits() const;
+        void DisplayLinkFits() const;
+
+        // @brief: Get the percentile of times by nearest rank
+        double GetPercentileTime(vector<double>& vec, double pct);
+
         // @brief: Dispaly Benchmark result
-        void PopulatePerfMatrix(bool peak, double* perf_matrix) const;
-        void PrintPerfMatrix(bool validate, bool peak, double* perf_matrix) const;
+        void PopulatePerfMatrix(uint32_t kind, uint32_t size_idx, double* perf_matrix) const;
+        void PrintPerfMatrix(bool validate, uint32_t kind, double* perf_matrix,
+                             const double* cv_matrix) const;
         void DisplayDevInfo() const;
         void DisplayIOTime(async_trans_t& trans) const;
         void DisplayCopyTime(async_trans_t& trans) const;
-        void DisplayCopyTimeMatrix(bool peak) const;
+        void DisplayCopyTimeMatrix(uint32_t kind) const;
+
+        // @brief: Display bandwidth of every pair of all device copies
+        // against every copy size, one row per pair
+        void DisplaySizePairTable(uint32_t kind) const;
+
+        // @brief: Get a value of a transaction shown by a matrix of
+        // given kind, e.g. peak bandwidth or its coefficient of variation
+        double GetPerfValue(const async_trans_t& trans, uint32_t kind, uint32_t size_idx) const;
+        std::string GetPerfTitle(uint32_t kind) const;
+
+        // @brief: Display matrices of every kind for all device copies
+        void DisplayCopyTimeMatrices() const;
+
+        // @brief: Display bandwidth of all device copies per pool, used
+        // when a device has several pools whose cells would collide in
+        // a matrix per device. Rows and columns are named Dev:Pool
+        bool HasMultiPoolAgent() const;
+        void PopulatePoolPerfMatrix(uint32_t kind, uint32_t size_idx, double* perf_matrix) const;
+        void DisplayPoolPerfMatrix(uint32_t kind, uint32_t size_idx) const;
+        void PrintPoolPerfMatrix(bool validate, uint32_t kind, const double* perf_matrix,
+                                 const double* cv_matrix) const;
+
+        // @brief: Get tag of a pool by its grain and kernarg flags
+        std::string GetPoolGrainTag(uint32_t pool_idx) const;
+
+        // @brief: Display bandwidth of copies between pools of every
+        // grain, with the cost of fine-grained pools on each link
+        // against copies between coarse-grained pools
+        void DisplayGrainComparison() const;
+
+        // @brief: Display outcome of validation of all device copies,
+        // per pool if a device has several pools
+        void PopulateValidationMatrix(bool per_pool, double* perf_matrix) const;
         void DisplayValidationMatrix() const;
 
+        void DisplayResults() const;
+
+        // @brief: Emit results of a transaction into the result sink
+        void OpenResultSink();
+        void EmitResults(const async_trans_t& trans);
+        void BuildResultEndpoint(uint32_t pool_idx, result_endpoint_t& endpoint) const;
+        void BuildResultRecords(const async_trans_t& trans,
+                                vector<result_record_t>& record_list) const;
+
+        // @brief: Compare results of the run against a baseline
+        void LoadBaselineResults();
+        void CompareBaseline();
+        void DisplayComparison() const;
+
     private:
         // @brief: Validate the arguments passed in by user
         bool ValidateArguments();
@@ -311,15 +741,50 @@ class RocmBandwidthTest : public BaseTest {
                                              vector<hsa_amd_memory_pool_t>& pool_list);
 
         void ReleaseBuffers(vector<void*>& buffer_list);
+
+        // @brief: Acquire a buffer from cache of buffers released by
+        // previous copies, allocating one if none is suitable
+        void* AcquireBuffer(hsa_amd_memory_pool_t pool, size_t size);
+        void FreeBufferCache();
+
+        // @brief: Acquire a signal of value one from cache of signals
+        // released by previous copies, creating one if cache is empty
+        hsa_signal_t AcquireSignal();
         void ReleaseSignals(vector<hsa_signal_t>& signal_list);
+        void FreeSignalCache();
 
         double GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd, hsa_signal_t signal_rev);
+        double GetGpuWindowTime(vector<hsa_signal_t>& signal_list, uint32_t signal_cnt);
 
         void InitializeSrcBuffer(size_t size, void* buf_cpy, uint32_t cpy_dev_idx,
                                  hsa_agent_t cpy_agent);
 
-        bool ValidateDstBuffer(size_t max_size, size_t curr_size, void* buf_cpy,
-                               uint32_t cpy_dev_idx, hsa_agent_t cpy_agent);
+        // @brief: Grow buffer of the source pattern to hold a copy of
+        // given size, reallocating it if it is smaller
+        void ReserveInitBuffer(size_t size);
+
+        // @brief: Stop the validation pipeline and free its snapshots
+        void ReleaseValidateBuffers();
+
+        // @brief: Free buffers of the source pattern and snapshots
+        void ReleaseInitBuffers();
+
+        // @brief: Snapshot a destination buffer into a host buffer
+        // and queue it for verification on the validation pipeline.
+        // Host visible destination buffers are verified in place
+        void SubmitDstValidation(size_t max_size, size_t curr_size, void* buf_cpy,
+                                 uint32_t cpy_dev_idx, hsa_agent_t cpy_agent, uint32_t flow);
+
+        // @brief: Wait until destination buffers queued for
+        // validation may be written by the next copy
+        void FenceDstValidation();
+
+        // @brief: Wait for queued snapshots to be verified and
+        // return the validation status of a flow
+        bool CollectDstValidation(size_t curr_size, uint32_t flow);
+
+        // @brief: Return hashes of the source pattern for a copy size
+        const vector<uint64_t>& GetInitHashes(size_t size);
 
         void copy_buffer(void* dst, hsa_agent_t dst_agent, void* src, hsa_agent_t src_agent,
                          size_t size, hsa_signal_t signal);
@@ -373,6 +838,7 @@ class RocmBandwidthTest : public BaseTest {
         void PrintVersion() const;
         void PrintLaunchCmd() const;
         std::string GetVersion() const;
+        std::string GetLaunchCmd() const;
 
         // Used to help count agent_info
         uint32_t agent_index_;
@@ -439,6 +905,10 @@ class RocmBandwidthTest : public BaseTest {
         static const uint32_t CPU_VISIBLE_TIME = 0x04;
         static const uint32_t DEV_COPY_LATENCY = 0x08;
         static const uint32_t VALIDATE_COPY_OP = 0x010;
+        static const uint32_t COPY_STREAMS = 0x020;
+        static const uint32_t COPY_QUEUE_DEPTH = 0x040;
+        static const uint32_t COPY_UNDER_LOAD = 0x080;
+        static const uint32_t COPY_SIZE_SEARCH = 0x100;
 
         static const uint32_t LINK_TYPE_SELF = 0x00;
         static const uint32_t LINK_TYPE_PCIE = 0x01;
@@ -451,9 +921,22 @@ class RocmBandwidthTest : public BaseTest {
         static const uint32_t LINK_PROP_WEIGHT = 0x02;
         static const uint32_t LINK_PROP_ACCESS = 0x03;
 
-        // Encodes validation failure
+        // Marks an entry of access or link matrices not yet discovered
+        static const uint32_t LINK_PROP_UNKNOWN = 0xFFFFFFFE;
+
+        // Encodes validation failure in a validation matrix
         static const double VALIDATE_COPY_OP_FAILURE;
 
+        // Kinds of bandwidth matrices of all device copies
+        static const uint32_t PERF_MATRIX_PEAK = 0x00;
+        static const uint32_t PERF_MATRIX_AVG = 0x01;
+        static const uint32_t PERF_MATRIX_STDDEV = 0x02;
+        static const uint32_t PERF_MATRIX_CV = 0x03;
+        static const uint32_t PERF_MATRIX_WORST = 0x04;
+
+        // Average bandwidth with links of high variation marked
+        static const uint32_t PERF_MATRIX_NOISY = 0x05;
+
         // List used to store transactions per user request
         vector<async_trans_t> trans_list_;
 
@@ -467,11 +950,25 @@ class RocmBandwidthTest : public BaseTest {
         uint32_t* link_weight_matrix_;
         uint32_t* direct_access_matrix_;
 
+        // Time spent discovering topology. Updated by discovery of
+        // access and link properties performed on first use
+        mutable setup_time_t setup_time_;
+
+        // Env key to print time spent discovering topology
+        char* bw_setup_timing_;
+
         // Env key to determine if Fine-grained or
         // Coarse-grained pool should be filtered out
         char* skip_cpu_fine_grain_;
         char* skip_gpu_coarse_grain_;
 
+        // Pools of every grain are discovered and copies between
+        // them compared if true, overriding the keys above
+        bool grain_compare_;
+
+        // Determines if progress of copies is printed
+        bool print_progress_;
+
         // Env key to determine if the run should block
         // or actively wait on completion signal
         char* bw_blocking_run_;
@@ -479,12 +976,42 @@ class RocmBandwidthTest : public BaseTest {
         // Env key to determine if the run is a default one
         char* bw_default_run_;
 
+        // Env key to specify path of topology snapshot and if the
+        // snapshot should be used in place of Roc Runtime to print
+        // topology
+        char* bw_topology_cache_;
+        char* bw_topology_offline_;
+
+        // Set if topology was restored from a snapshot without Roc
+        // Runtime, and if pairs of agents were discovered since the
+        // snapshot was last saved or loaded
+        bool topology_offline_;
+        mutable bool topology_dirty_;
+
         // Env key to specify iteration count
         char* bw_iter_cnt_;
+
+        // Shares of peak bandwidth in percent searched for and the
+        // outcome of search for every transaction
+        vector<size_t> search_pct_list_;
+        vector<size_search_t> search_list_;
+        static const size_t SEARCH_MIN_SIZE = 1024;
+        static const size_t SEARCH_MAX_SIZE = 512 * 1024 * 1024;
+
+        // Env keys of model fit to copy times and file to export fits
+        // into, and the fits of every transaction
+        char* bw_fit_;
+        char* bw_fit_file_;
+        bool fit_knee_;
+        vector<link_fit_t> fit_list_;
+
+        // Env keys and rates at which copies are paced, or gap in
+        // seconds before every copy
+        char* bw_rate_;
         char* bw_sleep_time_;
-        uint32_t sleep_time_;
+        vector<pace_spec_t> pace_list_;
+        double pace_gap_;
         std::chrono::nanoseconds cpu_cp_time_;
-        std::chrono::microseconds sleep_usecs_;
         std::chrono::time_point<std::chrono::steady_clock> cpu_end_;
         std::chrono::time_point<std::chrono::steady_clock> cpu_start_;
 
@@ -506,9 +1033,138 @@ class RocmBandwidthTest : public BaseTest {
 
         // Handles to buffer used to initialize and validate
         void* init_src_;
-        void* validate_dst_;
+        size_t init_src_size_;
         hsa_signal_t init_signal_;
 
+        // Host buffers used to snapshot destination buffers and
+        // the pipeline that verifies them in the background
+        vector<void*> validate_buf_list_;
+        size_t validate_buf_size_;
+
+        // Signals of snapshot copies, one per snapshot buffer, and
+        // those issued since destination buffers were last fenced
+        vector<hsa_signal_t> validate_sig_list_;
+        vector<hsa_signal_t> validate_fence_list_;
+        ValidatePipeline validate_pipeline_;
+        static const uint32_t VALIDATE_SNAPSHOT_CNT = 3;
+        static const uint32_t VALIDATE_WORKER_CNT = 2;
+
+        // Env key to validate only every Nth page of a copy
+        char* bw_validate_stride_;
+        uint32_t validate_stride_;
+
+        // Hashes of the source pattern, indexed by copy size
+        map<size_t, vector<uint64_t>> init_hash_map_;
+
+        // Buffers released by copy operations kept for reuse by the
+        // following copies, oldest first, and properties of every
+        // buffer allocated via the cache. Size of cache is bounded
+        vector<void*> buffer_cache_;
+        map<void*, cached_buffer_t> buffer_info_map_;
+        static const uint32_t BUFFER_CACHE_CNT = 4;
+
+        // Signals released by copy operations kept for reuse
+        vector<hsa_signal_t> signal_cache_;
+        static const uint32_t SIGNAL_CACHE_CNT = 16;
+
+        // Scenarios of scenario file, time taken by each and the
+        // start of session
+        char* scenario_path_;
+        vector<scenario_t> scenario_list_;
+        vector<double> scenario_time_list_;
+        std::chrono::time_point<std::chrono::steady_clock> session_start_;
+
+        // Settings of session inherited by scenarios
+        uint64_t session_iter_cnt_;
+        bool session_validate_;
+        char* session_blocking_;
+        char* session_skip_cpu_fine_grain_;
+        char* session_skip_gpu_coarse_grain_;
+
+        // Env keys and settings of order in which copies are run:
+        // transactions shuffled with a seed, sizes interleaved, rounds
+        // interleaved across transactions and number of rounds
+        char* bw_order_;
+        char* bw_order_seed_;
+        char* bw_rounds_;
+        bool order_shuffle_;
+        bool order_interleave_sizes_;
+        bool order_interleave_rounds_;
+        uint32_t order_seed_;
+        uint32_t round_cnt_;
+
+        // Time budget of health check in seconds, zero if disabled,
+        // env key to override expected bandwidth of link types and
+        // expected bandwidth in GB/s indexed by link type
+        double health_budget_;
+        char* bw_health_bw_;
+        double health_bw_[LINK_TYPE_IGNORED + 1];
+        vector<health_plan_t> health_list_;
+
+        // Maximum number of concurrent streams of a transaction, zero
+        // if disabled, and throughput for each number of streams
+        uint32_t stream_cnt_;
+        vector<stream_result_t> stream_list_;
+
+        // Queue depths at which small copies are kept in flight and
+        // their results, in order of size and depth
+        vector<size_t> queue_depth_list_;
+        vector<iops_result_t> iops_list_;
+        static const uint32_t IOPS_COPY_CNT = 4096;
+
+        // Pools of link loaded by background copies, env key and load
+        // levels in percent, and latency of probes at every level
+        vector<size_t> load_pair_;
+        char* bw_load_levels_;
+        vector<uint32_t> load_level_list_;
+        vector<load_result_t> load_list_;
+        static const size_t LOAD_BULK_SIZE = 64 * 1024 * 1024;
+        static const size_t LOAD_PROBE_SIZE = 4 * 1024;
+        static const uint32_t LOAD_PROBE_CNT = 1000;
+
+        // Time window spanned by concurrent copies in ticks, aggregate
+        // bandwidth over the window and fairness of copies, per size
+        vector<double> concurrent_window_time_;
+        vector<double> agg_bandwidth_list_;
+        vector<double> fairness_list_;
+
+        // Env key to rerun every concurrent copy by itself and
+        // report its slowdown
+        char* bw_isolated_;
+
+        // Path of socket served in daemon mode and env key to serve
+        // requests with a stub in place of Roc Runtime
+        char* daemon_path_;
+        char* bw_daemon_stub_;
+
+        // Sink used to emit results in a machine readable format and
+        // the file it writes into. Console output is replaced by the
+        // sink unless user has requested output be written to a file
+        ResultSink* result_sink_;
+        uint32_t sink_format_;
+        char* sink_path_;
+        std::ofstream sink_file_;
+
+        // Results of a previous run to compare against, indexed by
+        // key of result, and outcome of the comparison
+        char* baseline_path_;
+        map<std::string, result_record_t> baseline_map_;
+        vector<compare_record_t> compare_list_;
+
+        // Env key to specify the drop in bandwidth, in percent, that
+        // is tolerated before a result is considered a regression
+        char* bw_regression_tol_;
+        double regression_tol_;
+
+        // Env key to specify the coefficient of variation of copy
+        // times, in percent, above which a link is marked as noisy
+        char* bw_cv_limit_;
+        double cv_limit_;
+
+        // Env key to print matrices of average, spread and worst case
+        // bandwidth after peak bandwidth of all-device copies
+        char* bw_variation_;
+
         // Determines the latency overhead of copy operations
         bool latency_;
 
@@ -522,8 +1178,16 @@ class RocmBandwidthTest : public BaseTest {
         static const size_t SIZE_LIST[20];
         static const size_t LATENCY_SIZE_LIST[20];
 
-        // Exit value to return in case of error
+        // Exit value to return in case of error. Failed validation
+        // takes precedence over regression of performance
         int32_t exit_value_;
+
+        // Determines if errors are raised or end the process
+        bool error_raise_;
+        static const int32_t EXIT_VALIDATION_FAILURE = EXIT_FAILURE;
+        static const int32_t EXIT_PERF_REGRESSION = 2;
+        static const int32_t EXIT_HEALTH_FAILURE = 3;
+        static const int32_t EXIT_HEALTH_SKIPPED = 4;
 };
 
 #endif    //  __ROC_BANDWIDTH_TEST_H__
@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "checksum.hpp"
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdio.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Identifies a file as a topology snapshot and the layout of its
+// contents. Version must be bumped whenever the layout changes
+static const char TOPOLOGY_SNAPSHOT_MAGIC[8] = {'R', 'B', 'T', 'T', 'O', 'P', 'O', '\0'};
+static const uint32_t TOPOLOGY_SNAPSHOT_VERSION = 1;
+
+// Bounds on counts of agents and pools read from a snapshot, so a
+// corrupt file can't request huge allocations
+static const uint32_t TOPOLOGY_SNAPSHOT_MAX_AGENTS = 1024;
+static const uint32_t TOPOLOGY_SNAPSHOT_MAX_POOLS = 16 * 1024;
+
+template <typename T>
+static void WriteValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// @brief: Write a string field as a record of fixed size, zeroing
+// bytes past its end so snapshots carry no stale memory and files of
+// the same hardware are identical
+template <size_t N>
+static void WriteString(std::ofstream& file, const char (&value)[N]) {
+    char record[N];
+    std::memset(record, 0, N);
+    std::strncpy(record, value, N - 1);
+    file.write(record, N);
+}
+
+template <typename T>
+static bool ReadValue(std::ifstream& file, T& value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return file.good();
+}
+
+static void WriteMatrix(std::ofstream& file, const uint32_t* matrix, size_t count) {
+    file.write(reinterpret_cast<const char*>(matrix), count * sizeof(uint32_t));
+}
+
+static uint32_t* ReadMatrix(std::ifstream& file, size_t count) {
+    uint32_t* matrix = new uint32_t[count]();
+    file.read(reinterpret_cast<char*>(matrix), count * sizeof(uint32_t));
+    return matrix;
+}
+
+// @brief: Compute a fingerprint of the hardware from properties of
+// agents and pools that are cheap to query. Matrices of a snapshot
+// are reused only if its fingerprint matches that of the system
+uint64_t RocmBandwidthTest::GetTopologyFingerprint() const {
+    uint64_t hash = 0;
+    for (uint32_t idx = 0; idx < agent_list_.size(); idx++) {
+        const agent_info_t& agent = agent_list_[idx];
+        uint32_t dev_type = agent.device_type_;
+        hash = ComputeHash64(&dev_type, sizeof(dev_type), hash);
+        hash = ComputeHash64(agent.name_, strnlen(agent.name_, sizeof(agent.name_)), hash);
+        hash = ComputeHash64(agent.uuid_, strnlen(agent.uuid_, sizeof(agent.uuid_)), hash);
+        hash = ComputeHash64(agent.bdf_id_, strnlen(agent.bdf_id_, sizeof(agent.bdf_id_)), hash);
+    }
+    for (uint32_t idx = 0; idx < pool_list_.size(); idx++) {
+        const pool_info_t& pool = pool_list_[idx];
+        uint64_t props[] = {pool.agent_index_, pool.allocable_size_, pool.is_fine_grained_,
+                            pool.is_kernarg_, pool.access_to_all_, (uint64_t)pool.owner_access_};
+        hash = ComputeHash64(props, sizeof(props), hash);
+    }
+    return hash;
+}
+
+// @brief: Save the agents, pools and matrices of link properties
+// discovered on the system into snapshot file, if user has enabled
+// caching of topology and pairs of agents were discovered since it
+// was last saved or loaded. Pairs not yet discovered are saved as
+// unknown and discovered on first use by the run loading them
+void RocmBandwidthTest::SaveTopologySnapshot() const {
+    if ((bw_topology_cache_ == NULL) || (topology_dirty_ == false)) {
+        return;
+    }
+
+    // Write into a temporary file and move it in place once complete
+    // so a concurrent run never reads a partially written snapshot
+    std::string temp_path = std::string(bw_topology_cache_) + ".tmp";
+    std::ofstream file(temp_path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (file.is_open() == false) {
+        return;
+    }
+
+    uint32_t agent_cnt = agent_list_.size();
+    uint32_t pool_cnt = pool_list_.size();
+    file.write(TOPOLOGY_SNAPSHOT_MAGIC, sizeof(TOPOLOGY_SNAPSHOT_MAGIC));
+    WriteValue(file, TOPOLOGY_SNAPSHOT_VERSION);
+    WriteValue(file, GetTopologyFingerprint());
+    WriteValue(file, agent_cnt);
+    WriteValue(file, pool_cnt);
+    WriteValue(file, cpu_index_);
+
+    for (uint32_t idx = 0; idx < agent_cnt; idx++) {
+        const agent_info_t& agent = agent_list_[idx];
+        uint32_t dev_type = agent.device_type_;
+        WriteValue(file, agent.index_);
+        WriteValue(file, dev_type);
+        WriteString(file, agent.name_);
+        WriteString(file, agent.uuid_);
+        WriteString(file, agent.bdf_id_);
+    }
+
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        const pool_info_t& pool = pool_list_[idx];
+        uint64_t size = pool.allocable_size_;
+        uint32_t segment = pool.segment_;
+        uint32_t owner_access = pool.owner_access_;
+        WriteValue(file, pool.index_);
+        WriteValue(file, pool.agent_index_);
+        WriteValue(file, size);
+        WriteValue(file, segment);
+        WriteValue(file, owner_access);
+        WriteValue(file, pool.is_kernarg_);
+        WriteValue(file, pool.access_to_all_);
+        WriteValue(file, pool.is_fine_grained_);
+    }
+
+    size_t count = (size_t)agent_cnt * agent_cnt;
+    WriteMatrix(file, access_matrix_, count);
+    WriteMatrix(file, direct_access_matrix_, count);
+    WriteMatrix(file, link_hops_matrix_, count);
+    WriteMatrix(file, link_type_matrix_, count);
+    WriteMatrix(file, link_weight_matrix_, count);
+
+    bool status = file.good();
+    file.close();
+    if (status) {
+        rename(temp_path.c_str(), bw_topology_cache_);
+        topology_dirty_ = false;
+    } else {
+        remove(temp_path.c_str());
+    }
+}
+
+// @brief: Load matrices of link properties from snapshot file. In
+// online mode agents and pools have been discovered and a snapshot
+// is used only if it matches them. In offline mode, Roc Runtime is
+// not initialized and agents and pools are restored from snapshot
+// without handles, sufficient only to print topology
+bool RocmBandwidthTest::LoadTopologySnapshot(bool offline) {
+    if (bw_topology_cache_ == NULL) {
+        return false;
+    }
+
+    std::ifstream file(bw_topology_cache_, std::ios::in | std::ios::binary);
+    if (file.is_open() == false) {
+        return false;
+    }
+
+    char magic[sizeof(TOPOLOGY_SNAPSHOT_MAGIC)];
+    uint32_t version = 0;
+    uint64_t fingerprint = 0;
+    uint32_t agent_cnt = 0;
+    uint32_t pool_cnt = 0;
+    int32_t cpu_index = -1;
+    file.read(magic, sizeof(magic));
+    ReadValue(file, version);
+    ReadValue(file, fingerprint);
+    ReadValue(file, agent_cnt);
+    ReadValue(file, pool_cnt);
+    if ((ReadValue(file, cpu_index) == false) ||
+        (std::memcmp(magic, TOPOLOGY_SNAPSHOT_MAGIC, sizeof(magic)) != 0) ||
+        (version != TOPOLOGY_SNAPSHOT_VERSION)) {
+        return false;
+    }
+    if ((agent_cnt > TOPOLOGY_SNAPSHOT_MAX_AGENTS) || (pool_cnt > TOPOLOGY_SNAPSHOT_MAX_POOLS) ||
+        (cpu_index < -1) || (cpu_index >= (int32_t)agent_cnt)) {
+        return false;
+    }
+
+    // Snapshot must describe the hardware being run on
+    if (offline == false) {
+        if ((agent_cnt != agent_list_.size()) || (pool_cnt != pool_list_.size()) ||
+            (fingerprint != GetTopologyFingerprint())) {
+            return false;
+        }
+    }
+
+    vector<agent_info_t> agent_list;
+    for (uint32_t idx = 0; idx < agent_cnt; idx++) {
+        agent_info_t agent;
+        uint32_t dev_type = 0;
+        std::memset(&agent.agent_, 0, sizeof(agent.agent_));
+        ReadValue(file, agent.index_);
+        ReadValue(file, dev_type);
+        ReadValue(file, agent.name_);
+        ReadValue(file, agent.uuid_);
+        ReadValue(file, agent.bdf_id_);
+        agent.name_[sizeof(agent.name_) - 1] = '\0';
+        agent.uuid_[sizeof(agent.uuid_) - 1] = '\0';
+        agent.bdf_id_[sizeof(agent.bdf_id_) - 1] = '\0';
+        agent.device_type_ = (hsa_device_type_t)dev_type;
+        agent_list.push_back(agent);
+    }
+
+    vector<pool_info_t> pool_list;
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        pool_info_t pool;
+        uint64_t size = 0;
+        uint32_t segment = 0;
+        uint32_t owner_access = 0;
+        std::memset(&pool.pool_, 0, sizeof(pool.pool_));
+        std::memset(&pool.owner_agent_, 0, sizeof(pool.owner_agent_));
+        ReadValue(file, pool.index_);
+        ReadValue(file, pool.agent_index_);
+        ReadValue(file, size);
+        ReadValue(file, segment);
+        ReadValue(file, owner_access);
+        ReadValue(file, pool.is_kernarg_);
+        ReadValue(file, pool.access_to_all_);
+        ReadValue(file, pool.is_fine_grained_);
+        pool.allocable_size_ = size;
+        pool.segment_ = (hsa_amd_segment_t)segment;
+        pool.owner_access_ = (hsa_amd_memory_pool_access_t)owner_access;
+        if (pool.agent_index_ >= agent_cnt) {
+            return false;
+        }
+        pool_list.push_back(pool);
+    }
+
+    size_t count = (size_t)agent_cnt * agent_cnt;
+    uint32_t* matrix_list[5];
+    for (uint32_t idx = 0; idx < 5; idx++) {
+        matrix_list[idx] = ReadMatrix(file, count);
+    }
+    if (file.good() == false) {
+        for (uint32_t idx = 0; idx < 5; idx++) {
+            delete[] matrix_list[idx];
+        }
+        return false;
+    }
+    access_matrix_ = matrix_list[0];
+    direct_access_matrix_ = matrix_list[1];
+    link_hops_matrix_ = matrix_list[2];
+    link_type_matrix_ = matrix_list[3];
+    link_weight_matrix_ = matrix_list[4];
+
+    // Agents and pools discovered on the system hold valid handles
+    topology_dirty_ = false;
+    if (offline == false) {
+        return true;
+    }
+
+    // Rebuild lists of agents and pools as done by discovery
+    agent_list_ = agent_list;
+    pool_list_ = pool_list;
+    agent_pool_list_.clear();
+    for (uint32_t idx = 0; idx < agent_cnt; idx++) {
+        agent_pool_info_t node;
+        node.agent = agent_list_[idx];
+        agent_pool_list_.push_back(node);
+    }
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        agent_pool_list_[pool_list_[idx].agent_index_].pool_list.push_back(pool_list_[idx]);
+    }
+    agent_index_ = agent_cnt;
+    pool_index_ = pool_cnt;
+    cpu_index_ = cpu_index;
+    topology_offline_ = true;
+    return true;
+}
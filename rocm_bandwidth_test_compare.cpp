@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// @brief: Load results of a previous run if user has requested
+// the results of this run be compared against them
+void RocmBandwidthTest::LoadBaselineResults() {
+    if (baseline_path_ == NULL) {
+        return;
+    }
+
+    bool status = LoadBaseline(baseline_path_, baseline_map_);
+    if (status == false) {
+        std::cout << "Unable to open baseline file: " << baseline_path_ << std::endl;
+        ExitOrRaise(1);
+    }
+    if (baseline_map_.size() == 0) {
+        std::cout << "Baseline file has no results: " << baseline_path_ << std::endl;
+        ExitOrRaise(1);
+    }
+}
+
+// @brief: Compare results of every transaction against results of
+// the baseline with the same key. Exit value of the test is updated
+// if any of the links has regressed beyond tolerance
+void RocmBandwidthTest::CompareBaseline() {
+    if (baseline_path_ == NULL) {
+        return;
+    }
+
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        vector<result_record_t> record_list;
+        BuildResultRecords(trans_list_[idx], record_list);
+        for (uint32_t rec_idx = 0; rec_idx < record_list.size(); rec_idx++) {
+            compare_record_t result;
+            const result_record_t& curr = record_list[rec_idx];
+            map<std::string, result_record_t>::const_iterator base =
+                baseline_map_.find(GetRecordKey(curr));
+            if (base == baseline_map_.end()) {
+                result.curr_ = curr;
+                result.base_bandwidth_ = 0;
+                result.delta_ = 0;
+                result.t_stat_ = 0;
+                result.significant_ = false;
+                result.status_ = COMPARE_NO_BASELINE;
+            } else {
+                CompareRecord(base->second, curr, regression_tol_, result);
+            }
+            compare_list_.push_back(result);
+
+            if ((result.status_ == COMPARE_REGRESSED) && (exit_value_ == 0)) {
+                exit_value_ = EXIT_PERF_REGRESSION;
+            }
+        }
+    }
+}
+
+void RocmBandwidthTest::DisplayComparison() const {
+    uint32_t format = 15;
+    std::cout.setf(ios::left);
+
+    std::cout << std::endl;
+    std::cout << "Comparison against baseline: " << baseline_path_ << std::endl;
+    std::cout << "Tolerated drop in bandwidth: " << std::fixed << std::setprecision(2)
+              << regression_tol_ << "%" << std::endl;
+    std::cout << std::endl;
+
+    const char* header[] = {"Src Device", "Dst Device", "Data Size", "Base BW(GB/s)",
+                            "Curr BW(GB/s)", "Delta(%)", "t-stat", "Status"};
+    std::cout << std::setw(20) << "Mode";
+    for (uint32_t idx = 0; idx < (sizeof(header) / sizeof(header[0])); idx++) {
+        std::cout << std::setw(format) << header[idx];
+    }
+    std::cout << std::endl;
+
+    uint32_t regress_cnt = 0;
+    for (uint32_t idx = 0; idx < compare_list_.size(); idx++) {
+        const compare_record_t& result = compare_list_[idx];
+        std::stringstream src;
+        std::stringstream dst;
+        src << result.curr_.src_.dev_type_ << " " << result.curr_.src_.dev_idx_;
+        dst << result.curr_.dst_.dev_type_ << " " << result.curr_.dst_.dev_idx_;
+
+        std::cout << std::setprecision(3);
+        std::cout << std::setw(20) << result.curr_.mode_;
+        std::cout << std::setw(format) << src.str();
+        std::cout << std::setw(format) << dst.str();
+        std::cout << std::setw(format) << result.curr_.size_;
+        if (result.status_ == COMPARE_NO_BASELINE) {
+            std::cout << std::setw(format) << "N/A";
+            std::cout << std::setw(format) << result.curr_.avg_bandwidth_;
+            std::cout << std::setw(format) << "N/A";
+            std::cout << std::setw(format) << "N/A";
+            std::cout << std::setw(format) << "NO BASELINE" << std::endl;
+            continue;
+        }
+
+        std::cout << std::setw(format) << result.base_bandwidth_;
+        std::cout << std::setw(format) << result.curr_.avg_bandwidth_;
+        std::cout << std::setw(format) << result.delta_;
+        std::cout << std::setw(format) << result.t_stat_;
+        if (result.status_ == COMPARE_REGRESSED) {
+            std::cout << std::setw(format) << "REGRESSED";
+            regress_cnt++;
+        } else if (result.status_ == COMPARE_IMPROVED) {
+            std::cout << std::setw(format) << "IMPROVED";
+        } else {
+            std::cout << std::setw(format) << "OK";
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << "Regressed results: " << regress_cnt << " of " << compare_list_.size()
+              << std::endl;
+    std::cout << std::endl;
+}
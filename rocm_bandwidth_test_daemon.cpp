@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "request_server.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <cstring>
+#include <iostream>
+
+// Number of Gpu devices of the topology served by the stub, along
+// with the bandwidth of its copies and size of its pools
+static const uint32_t STUB_GPU_CNT = 2;
+static const double STUB_BANDWIDTH = 25.0;
+static const size_t STUB_POOL_SIZE = 16ULL * 1024 * 1024 * 1024;
+
+// Handles requests of clients by running them on the bandwidth test
+// object of the daemon, reusing its Roc Runtime, topology, signals
+// and buffers
+class EngineRequestHandler : public RequestHandler {
+    public:
+        EngineRequestHandler(RocmBandwidthTest& test) : test_(test) {}
+
+        virtual bool Handle(const scenario_t& request, vector<result_record_t>& record_list,
+                            std::string& error) {
+            if (test_.RunRequest(request, record_list) == false) {
+                error = "request is invalid for this system";
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        RocmBandwidthTest& test_;
+};
+
+// @brief: Build a topology of a Cpu and Gpu devices, each with one
+// pool, without Roc Runtime. Gpu devices are bound to the Cpu by
+// PCIe and to one another by XGMI, and every device can access all
+void RocmBandwidthTest::BuildStubTopology() {
+    hsa_agent_t agent;
+    hsa_amd_memory_pool_t pool;
+    std::memset(&agent, 0, sizeof(agent));
+    std::memset(&pool, 0, sizeof(pool));
+    uint32_t agent_cnt = STUB_GPU_CNT + 1;
+    for (uint32_t idx = 0; idx < agent_cnt; idx++) {
+        bool is_cpu = (idx == 0);
+        agent_info_t agent_info(agent, idx, (is_cpu) ? HSA_DEVICE_TYPE_CPU : HSA_DEVICE_TYPE_GPU);
+        snprintf(agent_info.name_, sizeof(agent_info.name_), "stub");
+        if (is_cpu == false) {
+            snprintf(agent_info.uuid_, sizeof(agent_info.uuid_), "GPU-STUB%u", idx);
+        }
+        agent_list_.push_back(agent_info);
+
+        // Cpu pool is fine-grained and Gpu pools coarse-grained as
+        // with the default filters on grain of pools
+        pool_info_t pool_info(agent, idx, pool, HSA_AMD_SEGMENT_GLOBAL, STUB_POOL_SIZE, idx, is_cpu,
+                              is_cpu, true, HSA_AMD_MEMORY_POOL_ACCESS_ALLOWED_BY_DEFAULT);
+        pool_list_.push_back(pool_info);
+        agent_pool_info_t node;
+        node.agent = agent_info;
+        node.pool_list.push_back(pool_info);
+        agent_pool_list_.push_back(node);
+    }
+    agent_index_ = agent_cnt;
+    pool_index_ = agent_cnt;
+    cpu_index_ = 0;
+
+    // Link properties are known up front so none is discovered
+    AllocateLinkMatrices();
+    for (uint32_t src_dev_idx = 0; src_dev_idx < agent_cnt; src_dev_idx++) {
+        for (uint32_t dst_dev_idx = 0; dst_dev_idx < agent_cnt; dst_dev_idx++) {
+            uint32_t idx = (src_dev_idx * agent_cnt) + dst_dev_idx;
+            bool self = (src_dev_idx == dst_dev_idx);
+            bool xgmi = ((src_dev_idx != 0) && (dst_dev_idx != 0));
+            access_matrix_[idx] = 1;
+            direct_access_matrix_[idx] = 1;
+            link_hops_matrix_[idx] = (self) ? 0 : 1;
+            link_weight_matrix_[idx] = (self) ? 0 : ((xgmi) ? 15 : 20);
+            link_type_matrix_[idx] =
+                (self) ? LINK_TYPE_SELF : ((xgmi) ? LINK_TYPE_XGMI : LINK_TYPE_PCIE);
+        }
+    }
+}
+
+// @brief: Stand in for running planned copies. Every copy is timed
+// as if it moved its size at the stub bandwidth, timed by the Cpu,
+// and passes validation. Bandwidth is computed as for copies run
+void RocmBandwidthTest::RunStubTransList() {
+    uint32_t size_len = size_list_.size();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        async_trans_t& trans = trans_list_[idx];
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            // Size in bytes over bandwidth in GB/s is time in ns
+            double time = size_list_[sdx] / STUB_BANDWIDTH;
+            trans.cpu_min_time_.push_back(time);
+            trans.cpu_avg_time_.push_back(time);
+            trans.cpu_std_time_.push_back(0);
+            trans.cpu_max_time_.push_back(time);
+            if (validate_) {
+                trans.fwd_valid_.push_back(true);
+                if (trans.copy.bidir_) {
+                    trans.rev_valid_.push_back(true);
+                }
+            }
+        }
+        ComputeCopyTime(trans);
+    }
+}
+
+bool RocmBandwidthTest::RunRequest(const scenario_t& scenario,
+                                   vector<result_record_t>& record_list) {
+    BindScenarioSettings(scenario);
+    if (PlanScenario(scenario) == false) {
+        return false;
+    }
+
+    // Stub stands in for copies only, requests are planned and their
+    // results built by the engine as for copies that are run
+    if (bw_daemon_stub_ != NULL) {
+        RunStubTransList();
+    } else {
+        RunTransList();
+    }
+    GetResults(record_list);
+    return true;
+}
+
+void RocmBandwidthTest::RunDaemon() {
+    SaveSessionSettings();
+
+    std::string error;
+    EngineRequestHandler handler(*this);
+    RequestServer server(daemon_path_, handler);
+    if (server.Open(error) == false) {
+        std::cout << "Unable to start daemon: " << error << std::endl;
+        exit(1);
+    }
+    std::cout << "Serving requests on " << daemon_path_ << std::endl;
+    server.Serve();
+    server.Close();
+}
@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// Fit time = alpha + size * inv_beta to a range of points by least
+// squares of errors relative to measured times, so small sizes weigh
+// as much as large ones. Returns sum of squared relative errors
+static double FitSegment(const vector<double>& size_list, const vector<double>& time_list,
+                         uint32_t first, uint32_t last, double& alpha, double& inv_beta) {
+    double sw = 0, sws = 0, swt = 0, swss = 0, swst = 0;
+    for (uint32_t idx = first; idx < last; idx++) {
+        double weight = 1 / (time_list[idx] * time_list[idx]);
+        sw += weight;
+        sws += weight * size_list[idx];
+        swt += weight * time_list[idx];
+        swss += weight * size_list[idx] * size_list[idx];
+        swst += weight * size_list[idx] * time_list[idx];
+    }
+
+    // Latency can't be negative, refit bandwidth alone if it is
+    double det = (sw * swss) - (sws * sws);
+    alpha = (det != 0) ? (((swss * swt) - (sws * swst)) / det) : 0;
+    inv_beta = (det != 0) ? (((sw * swst) - (sws * swt)) / det) : 0;
+    if ((alpha < 0) || (det == 0)) {
+        alpha = 0;
+        inv_beta = swst / swss;
+    }
+
+    double error = 0;
+    for (uint32_t idx = first; idx < last; idx++) {
+        double rel = (time_list[idx] - alpha - (size_list[idx] * inv_beta)) / time_list[idx];
+        error += rel * rel;
+    }
+    return error;
+}
+
+// Size at which bandwidth of a segment reaches half of peak bandwidth
+static double GetHalfSize(double alpha, double inv_beta, double peak) {
+    double share = inv_beta * peak / 2;
+    if (share >= 1) {
+        return -1;
+    }
+    return (alpha * peak / 2) / (1 - share);
+}
+
+void RocmBandwidthTest::FitLinkModels() {
+    fit_list_.clear();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ != REQ_COPY_BIDIR) && (trans.req_type_ != REQ_COPY_UNIDIR) &&
+            (trans.req_type_ != REQ_COPY_ALL_BIDIR) && (trans.req_type_ != REQ_COPY_ALL_UNIDIR)) {
+            continue;
+        }
+
+        // A line needs at least two sizes. Size of data is adjusted
+        // as it is for bandwidth
+        uint32_t size_len = trans.avg_time_.size();
+        if (size_len < 2) {
+            continue;
+        }
+        double data_scale = 1;
+        if (trans.copy.bidir_) {
+            data_scale += 1;
+        }
+        if (trans.copy.src_idx_ == trans.copy.dst_idx_) {
+            data_scale += data_scale;
+        }
+        vector<double> size_list;
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            size_list.push_back(size_list_[sdx] * data_scale);
+        }
+
+        link_fit_t fit;
+        fit.trans_idx_ = idx;
+        fit.knee_size_ = 0;
+        double alpha = 0;
+        double inv_beta = 0;
+        double error = FitSegment(size_list, trans.avg_time_, 0, size_len, alpha, inv_beta);
+
+        // Knee splits sizes into two segments of two sizes or more,
+        // chosen to minimize error of both segments
+        double knee_alpha = 0;
+        double knee_inv_beta = 0;
+        if (fit_knee_) {
+            for (uint32_t kdx = 2; kdx + 2 <= size_len; kdx++) {
+                double lo_alpha, lo_inv_beta, hi_alpha, hi_inv_beta;
+                double lo_error =
+                    FitSegment(size_list, trans.avg_time_, 0, kdx, lo_alpha, lo_inv_beta);
+                double hi_error =
+                    FitSegment(size_list, trans.avg_time_, kdx, size_len, hi_alpha, hi_inv_beta);
+                if ((lo_error + hi_error) < error) {
+                    error = lo_error + hi_error;
+                    alpha = lo_alpha;
+                    inv_beta = lo_inv_beta;
+                    knee_alpha = hi_alpha;
+                    knee_inv_beta = hi_inv_beta;
+                    fit.knee_size_ = size_list_[kdx];
+                }
+            }
+        }
+
+        // Bandwidth of largest sizes is the asymptotic bandwidth
+        double peak_inv_beta = (fit.knee_size_ != 0) ? knee_inv_beta : inv_beta;
+        double peak = (peak_inv_beta > 0) ? (1 / peak_inv_beta) : 0;
+        fit.alpha_ = alpha;
+        fit.beta_ = (inv_beta > 0) ? (1 / inv_beta / 1000 / 1000 / 1000) : 0;
+        fit.knee_alpha_ = knee_alpha;
+        fit.knee_beta_ = (knee_inv_beta > 0) ? (1 / knee_inv_beta / 1000 / 1000 / 1000) : 0;
+
+        // Half bandwidth size is a size of copy, as the knee is, and
+        // not the size of data it moves
+        double half_size = GetHalfSize(alpha, inv_beta, peak);
+        double knee_data_size = fit.knee_size_ * data_scale;
+        if ((fit.knee_size_ != 0) && ((half_size < 0) || (half_size > knee_data_size))) {
+            half_size = GetHalfSize(knee_alpha, knee_inv_beta, peak);
+        }
+        fit.half_size_ = (half_size < 0) ? half_size : (half_size / data_scale);
+        fit.residual_ = sqrt(error / size_len);
+        fit_list_.push_back(fit);
+    }
+}
+
+void RocmBandwidthTest::ExportLinkFits() const {
+    if (bw_fit_file_ == NULL) {
+        return;
+    }
+
+    std::ofstream file(bw_fit_file_, std::ios::out | std::ios::trunc);
+    if (file.is_open() == false) {
+        std::cout << "Unable to open file to export model fits: " << bw_fit_file_ << std::endl;
+        ExitOrRaise(1);
+    }
+
+    // Every link is an object of latency in seconds, bandwidth in bytes
+    // per second and sizes in bytes, ready for a cost model to load
+    file << "{\"links\": [";
+    uint32_t fit_size = fit_list_.size();
+    for (uint32_t idx = 0; idx < fit_size; idx++) {
+        const link_fit_t& fit = fit_list_[idx];
+        const async_trans_t& trans = trans_list_[fit.trans_idx_];
+        uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+        file << ((idx == 0) ? "\n" : ",\n");
+        file << std::setprecision(9);
+        file << "  {\"src_pool\": " << trans.copy.src_idx_;
+        file << ", \"dst_pool\": " << trans.copy.dst_idx_;
+        file << ", \"src_dev\": " << src_dev_idx;
+        file << ", \"dst_dev\": " << dst_dev_idx;
+        file << ", \"bidir\": " << ((trans.copy.bidir_) ? "true" : "false");
+        file << ", \"alpha\": " << fit.alpha_;
+        file << ", \"beta\": " << (fit.beta_ * 1000 * 1000 * 1000);
+        file << ", \"knee\": " << fit.knee_size_;
+        file << ", \"knee_alpha\": " << fit.knee_alpha_;
+        file << ", \"knee_beta\": " << (fit.knee_beta_ * 1000 * 1000 * 1000);
+        file << ", \"half_bandwidth_size\": " << fit.half_size_;
+        file << ", \"residual\": " << fit.residual_ << "}";
+    }
+    file << "\n]}\n";
+}
+
+void RocmBandwidthTest::DisplayLinkFits() const {
+    std::cout << std::endl;
+    std::cout << "Latency (us) and bandwidth (GB/s) fit to copy times" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(22) << "Src Pool -> Dst Pool";
+    std::cout << std::setw(12) << "Latency";
+    std::cout << std::setw(12) << "Bandwidth";
+    if (fit_knee_) {
+        std::cout << std::setw(14) << "Knee (MB)";
+        std::cout << std::setw(12) << "Latency";
+        std::cout << std::setw(12) << "Bandwidth";
+    }
+    std::cout << std::setw(16) << "Half BW (MB)";
+    std::cout << std::setw(14) << "Residual (%)" << std::endl;
+
+    uint32_t fit_size = fit_list_.size();
+    for (uint32_t idx = 0; idx < fit_size; idx++) {
+        const link_fit_t& fit = fit_list_[idx];
+        const async_trans_t& trans = trans_list_[fit.trans_idx_];
+        std::string pair = std::to_string(trans.copy.src_idx_) +
+                           ((trans.copy.bidir_) ? " <-> " : " -> ") +
+                           std::to_string(trans.copy.dst_idx_);
+        std::cout << std::setw(22) << pair;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << std::setw(12) << (fit.alpha_ * 1000 * 1000);
+        std::cout << std::setw(12) << fit.beta_;
+        if (fit_knee_) {
+            if (fit.knee_size_ != 0) {
+                std::cout << std::setw(14) << ((double)fit.knee_size_ / (1024 * 1024));
+                std::cout << std::setw(12) << (fit.knee_alpha_ * 1000 * 1000);
+                std::cout << std::setw(12) << fit.knee_beta_;
+            } else {
+                std::cout << std::setw(14) << "N/A" << std::setw(12) << "N/A";
+                std::cout << std::setw(12) << "N/A";
+            }
+        }
+        if (fit.half_size_ < 0) {
+            std::cout << std::setw(16) << "N/A";
+        } else {
+            std::cout << std::setw(16) << (fit.half_size_ / (1024 * 1024));
+        }
+        std::cout << std::setw(14) << (fit.residual_ * 100) << std::endl;
+    }
+    std::cout << std::endl;
+}
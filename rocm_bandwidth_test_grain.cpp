@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+std::string RocmBandwidthTest::GetPoolGrainTag(uint32_t pool_idx) const {
+    // Kernarg pools are fine-grained pools of system memory
+    const pool_info_t& pool = pool_list_[pool_idx];
+    if (pool.is_kernarg_) {
+        return "kernarg";
+    }
+    return (pool.is_fine_grained_) ? "fine" : "coarse";
+}
+
+void RocmBandwidthTest::DisplayGrainComparison() const {
+    // Group copies by pair of devices, keeping order of pools
+    map<uint64_t, vector<uint32_t>> link_map;
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        uint64_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+        uint64_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+        link_map[(src_dev_idx * agent_index_) + dst_dev_idx].push_back(idx);
+    }
+
+    uint32_t format = 12;
+    uint32_t size_len = size_list_.size();
+    for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+        std::cout << std::endl;
+        std::cout << "Average bandwidth (GB/s) of copies between pools of every grain";
+        std::cout << ", size " << std::fixed << std::setprecision(3)
+                  << ((double)size_list_[sdx] / (1024 * 1024)) << " MB" << std::endl;
+        std::cout << "Cost (%) is the drop in bandwidth against the fastest copy with the"
+                  << " fewest fine-grained pools between the same devices" << std::endl;
+        std::cout << std::endl;
+        std::cout.setf(ios::left);
+        std::cout << std::setw(format) << "Src Dev";
+        std::cout << std::setw(format) << "Src Pool";
+        std::cout << std::setw(format) << "Src Grain";
+        std::cout << std::setw(format) << "Dst Dev";
+        std::cout << std::setw(format) << "Dst Pool";
+        std::cout << std::setw(format) << "Dst Grain";
+        std::cout << std::setw(format) << "Bandwidth";
+        std::cout << std::setw(format) << "Cost" << std::endl;
+
+        map<uint64_t, vector<uint32_t>>::const_iterator iter;
+        for (iter = link_map.begin(); iter != link_map.end(); iter++) {
+            const vector<uint32_t>& link_list = iter->second;
+
+            // Copies with the fewest fine-grained pools are the baseline,
+            // as a device may have no pool of coarse grain, e.g. a Cpu
+            uint32_t base_fine_cnt = 2;
+            double base_bandwidth = 0;
+            for (uint32_t ldx = 0; ldx < link_list.size(); ldx++) {
+                const async_trans_t& trans = trans_list_[link_list[ldx]];
+                uint32_t fine_cnt = pool_list_[trans.copy.src_idx_].is_fine_grained_ +
+                                    pool_list_[trans.copy.dst_idx_].is_fine_grained_;
+                if (fine_cnt < base_fine_cnt) {
+                    base_fine_cnt = fine_cnt;
+                    base_bandwidth = 0;
+                }
+                if (fine_cnt == base_fine_cnt) {
+                    base_bandwidth = max(base_bandwidth, trans.avg_bandwidth_[sdx]);
+                }
+            }
+
+            std::cout << std::endl;
+            for (uint32_t ldx = 0; ldx < link_list.size(); ldx++) {
+                const async_trans_t& trans = trans_list_[link_list[ldx]];
+                uint32_t src_idx = trans.copy.src_idx_;
+                uint32_t dst_idx = trans.copy.dst_idx_;
+                double bandwidth = trans.avg_bandwidth_[sdx];
+                std::cout << std::setw(format) << pool_list_[src_idx].agent_index_;
+                std::cout << std::setw(format) << src_idx;
+                std::cout << std::setw(format) << GetPoolGrainTag(src_idx);
+                std::cout << std::setw(format) << pool_list_[dst_idx].agent_index_;
+                std::cout << std::setw(format) << dst_idx;
+                std::cout << std::setw(format) << GetPoolGrainTag(dst_idx);
+                std::cout << std::setw(format) << std::fixed << std::setprecision(3) << bandwidth;
+                if (base_bandwidth > 0) {
+                    std::cout << std::setw(format) << ((1 - (bandwidth / base_bandwidth)) * 100);
+                } else {
+                    std::cout << std::setw(format) << "N/A";
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Bounds on size of copies and iterations planned by health check
+static const size_t HEALTH_MIN_SIZE = 1 * 1024 * 1024;
+static const size_t HEALTH_MAX_SIZE = 64 * 1024 * 1024;
+static const uint32_t HEALTH_MIN_ITER_CNT = 2;
+
+// Estimated fixed cost in seconds of a copy and of setting up the
+// buffers of a transaction
+static const double HEALTH_COPY_LATENCY = 20e-6;
+static const double HEALTH_SETUP_COST = 5e-3;
+
+// A link measuring less than this fraction of its expected bandwidth
+// has clearly failed and ends the health check early
+static const double HEALTH_CLEAR_FAILURE = 0.5;
+
+// Names of link types in order of their values
+static const char* HEALTH_LINK_NAME[] = {"self", "pcie", "xgmi", "other"};
+
+// @brief: Parse expected bandwidth of link types given as a list of
+// type=GB/s pairs e.g. pcie=12,xgmi=40,self=20,other=8
+static bool ParseHealthBandwidth(const char* value, double* bandwidth) {
+    uint32_t type_cnt = sizeof(HEALTH_LINK_NAME) / sizeof(HEALTH_LINK_NAME[0]);
+    std::stringstream stream(value);
+    std::string token;
+    while (std::getline(stream, token, ',')) {
+        size_t pos = token.find('=');
+        if (pos == std::string::npos) {
+            return false;
+        }
+        std::string type = token.substr(0, pos);
+        char* end = NULL;
+        double num = strtod(token.c_str() + pos + 1, &end);
+        if ((*end != '\0') || (num <= 0)) {
+            return false;
+        }
+        uint32_t idx = 0;
+        while ((idx < type_cnt) && (type != HEALTH_LINK_NAME[idx])) {
+            idx++;
+        }
+        if (idx == type_cnt) {
+            return false;
+        }
+        bandwidth[idx] = num;
+    }
+    return true;
+}
+
+void RocmBandwidthTest::PlanHealthCheck(const async_trans_t& trans, double share,
+                                        health_plan_t& plan) const {
+    uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+    plan.link_type_ = GetLinkProp(LINK_PROP_TYPE, src_dev_idx, dst_dev_idx);
+    if (plan.link_type_ > LINK_TYPE_IGNORED) {
+        plan.link_type_ = LINK_TYPE_IGNORED;
+    }
+    plan.expected_bw_ = health_bw_[plan.link_type_];
+    plan.bandwidth_ = 0;
+    plan.status_ = HEALTH_SKIPPED;
+
+    // Copies of a device to itself move data twice. Cost of a copy is
+    // estimated assuming link runs at its expected bandwidth
+    double scale = (src_dev_idx == dst_dev_idx) ? 2 : 1;
+    double bytes_per_sec = plan.expected_bw_ * 1000 * 1000 * 1000;
+
+    // Pick the largest size for which the minimum number of copies
+    // fits within share, one more copy being run to warm up
+    size_t size = HEALTH_MAX_SIZE;
+    double copy_cost = 0;
+    while (true) {
+        copy_cost = HEALTH_COPY_LATENCY + (scale * size / bytes_per_sec);
+        double cost = HEALTH_SETUP_COST + ((HEALTH_MIN_ITER_CNT + 1) * copy_cost);
+        if ((cost <= share) || (size <= HEALTH_MIN_SIZE)) {
+            break;
+        }
+        size = size / 2;
+    }
+
+    // Use rest of share for more iterations, up to those of a full run
+    uint32_t iter_cnt = HEALTH_MIN_ITER_CNT;
+    while ((iter_cnt < num_iteration_) &&
+           (HEALTH_SETUP_COST + ((iter_cnt + 2) * copy_cost) <= share)) {
+        iter_cnt++;
+    }
+    plan.size_ = size;
+    plan.iter_cnt_ = iter_cnt;
+    plan.cost_ = HEALTH_SETUP_COST + ((iter_cnt + 1) * copy_cost);
+}
+
+void RocmBandwidthTest::RunHealthCheck() {
+    health_bw_[LINK_TYPE_SELF] = 5;
+    health_bw_[LINK_TYPE_PCIE] = 8;
+    health_bw_[LINK_TYPE_XGMI] = 20;
+    health_bw_[LINK_TYPE_IGNORED] = 5;
+    if ((bw_health_bw_ != NULL) && (ParseHealthBandwidth(bw_health_bw_, health_bw_) == false)) {
+        std::cout << "Value of ROCM_BW_HEALTH_BW is invalid: " << bw_health_bw_ << std::endl;
+        ExitOrRaise(1);
+    }
+
+    // Enable profiling of Async Copy Activity
+    if (print_cpu_time_ == false) {
+        err_ = hsa_amd_profiling_async_copy_enable(true);
+        ErrorCheck(err_);
+    }
+
+    // Budget left after setting up is spread evenly over links not yet
+    // checked, so links that finish early leave time for later ones
+    uint64_t session_iter_cnt = num_iteration_;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - session_start_;
+    double remaining = health_budget_ - elapsed.count();
+    bool clear_failure = false;
+    bool skipped = false;
+    health_list_.clear();
+
+    // Size of copies is planned per link, so buffer of the source
+    // pattern is allocated for the largest one up front
+    ReserveInitBuffer(HEALTH_MAX_SIZE);
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        async_trans_t& trans = trans_list_[idx];
+        health_plan_t plan;
+        PlanHealthCheck(trans, remaining / (trans_size - idx), plan);
+        if ((clear_failure) || (plan.cost_ > remaining)) {
+            health_list_.push_back(plan);
+            skipped = true;
+            continue;
+        }
+
+        std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+        size_list_.assign(1, plan.size_);
+        set_num_iteration(plan.iter_cnt_);
+        RunCopyBenchmark(trans);
+        ComputeCopyTime(trans);
+        EmitResults(trans);
+
+        plan.bandwidth_ = trans.avg_bandwidth_[0];
+        plan.status_ = (plan.bandwidth_ >= plan.expected_bw_) ? HEALTH_PASS : HEALTH_FAIL;
+        if ((validate_) && ((trans.fwd_valid_[0] == false) ||
+                            ((trans.copy.bidir_) && (trans.rev_valid_[0] == false)))) {
+            plan.status_ = HEALTH_FAIL;
+            clear_failure = true;
+        }
+        if (plan.bandwidth_ < (plan.expected_bw_ * HEALTH_CLEAR_FAILURE)) {
+            clear_failure = true;
+        }
+        if (plan.status_ == HEALTH_FAIL) {
+            exit_value_ = (exit_value_ == 0) ? EXIT_HEALTH_FAILURE : exit_value_;
+        }
+        health_list_.push_back(plan);
+        elapsed = std::chrono::steady_clock::now() - start;
+        remaining -= elapsed.count();
+    }
+    set_num_iteration(session_iter_cnt);
+
+    // Links left unchecked must not let a gate pass, but a failure
+    // says more about the system and takes precedence
+    if ((skipped) && (exit_value_ == 0)) {
+        exit_value_ = EXIT_HEALTH_SKIPPED;
+    }
+
+    // Disable profiling of Async Copy Activity
+    if (print_cpu_time_ == false) {
+        err_ = hsa_amd_profiling_async_copy_enable(false);
+        ErrorCheck(err_);
+    }
+}
+
+void RocmBandwidthTest::DisplayHealthCheck() const {
+    const char* link_name[] = {"Self", "PCIe", "XGMI", "Other"};
+    const char* status_name[] = {"PASS", "FAIL", "SKIPPED"};
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - session_start_;
+
+    std::cout << std::endl;
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    std::cout << "Health Check, budget " << health_budget_ << " sec, took " << elapsed.count()
+              << " sec" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(10) << "Src Pool" << std::setw(10) << "Dst Pool" << std::setw(8)
+              << "Link" << std::setw(12) << "Size (MB)" << std::setw(8) << "Iter"
+              << std::setw(18) << "Expected (GB/s)" << std::setw(18) << "Measured (GB/s)"
+              << std::setw(10) << "Status" << std::endl;
+
+    uint32_t pass_cnt = 0;
+    uint32_t health_cnt = health_list_.size();
+    for (uint32_t idx = 0; idx < health_cnt; idx++) {
+        const health_plan_t& plan = health_list_[idx];
+        const async_trans_t& trans = trans_list_[idx];
+        std::cout << std::setw(10) << trans.copy.src_idx_ << std::setw(10) << trans.copy.dst_idx_
+                  << std::setw(8) << link_name[plan.link_type_] << std::setw(12)
+                  << (plan.size_ / (1024 * 1024)) << std::setw(8) << plan.iter_cnt_
+                  << std::setw(18) << plan.expected_bw_ << std::setw(18);
+        if (plan.status_ == HEALTH_SKIPPED) {
+            std::cout << "N/A";
+        } else {
+            std::cout << plan.bandwidth_;
+        }
+        std::cout << std::setw(10) << status_name[plan.status_] << std::endl;
+        pass_cnt += (plan.status_ == HEALTH_PASS) ? 1 : 0;
+    }
+    std::cout << std::endl;
+    std::cout << "  " << pass_cnt << " of " << health_cnt << " links passed" << std::endl;
+    std::cout << std::endl;
+}
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+void RocmBandwidthTest::RunQueueDepthCopies(copy_resources_t& res, uint32_t depth, size_t size,
+                                            iops_result_t& result) {
+    hsa_wait_state_t policy =
+        (bw_blocking_run_ == NULL) ? HSA_WAIT_STATE_ACTIVE : HSA_WAIT_STATE_BLOCKED;
+
+    // Every copy in flight writes its own slot of destination buffer
+    // and completes on its own signal of the rolling pool
+    vector<hsa_signal_t>& signal_list = res.signal_list_;
+    vector<std::chrono::time_point<std::chrono::steady_clock>> issue_list(depth);
+    vector<double> lat_list;
+    uint32_t issue_cnt = 0;
+    uint32_t done_cnt = 0;
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+    while (done_cnt < IOPS_COPY_CNT) {
+        // Fill up the queue to its depth
+        while ((issue_cnt < IOPS_COPY_CNT) && ((issue_cnt - done_cnt) < depth)) {
+            uint32_t slot = issue_cnt % depth;
+            uint8_t* buf_dst = (uint8_t*)res.buf_dst_fwd_ + (slot * size);
+            hsa_signal_store_relaxed(signal_list[slot], 1);
+            issue_list[slot] = std::chrono::steady_clock::now();
+            err_ = hsa_amd_memory_async_copy(buf_dst, res.dst_agent_fwd_, res.buf_src_fwd_,
+                                             res.src_agent_fwd_, size, 0, NULL, signal_list[slot]);
+            ErrorCheck(err_);
+            issue_cnt++;
+        }
+
+        // Retire the oldest copy in flight
+        uint32_t slot = done_cnt % depth;
+        while (hsa_signal_wait_acquire(signal_list[slot], HSA_SIGNAL_CONDITION_LT, 1,
+                                       uint64_t(-1), policy))
+            ;
+        std::chrono::duration<double, std::micro> lat_time =
+            std::chrono::steady_clock::now() - issue_list[slot];
+        lat_list.push_back(lat_time.count());
+        done_cnt++;
+    }
+    std::chrono::duration<double> run_time = std::chrono::steady_clock::now() - start;
+
+    result.depth_ = depth;
+    result.size_ = size;
+    result.copy_rate_ = IOPS_COPY_CNT / run_time.count();
+    result.lat_p50_ = GetPercentileTime(lat_list, 50);
+    result.lat_p90_ = GetPercentileTime(lat_list, 90);
+    result.lat_p99_ = GetPercentileTime(lat_list, 99);
+    result.lat_max_ = lat_list.back();
+}
+
+void RocmBandwidthTest::RunQueueDepthSweep() {
+    iops_list_.clear();
+    size_t max_size = size_list_.back();
+    uint32_t max_depth = *std::max_element(queue_depth_list_.begin(), queue_depth_list_.end());
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if (trans.req_type_ != REQ_COPY_UNIDIR) {
+            continue;
+        }
+
+        // Destination buffer holds a slot of largest size per copy in flight
+        copy_resources_t res;
+        res.bidir_ = false;
+        res.max_size_ = max_size;
+        res.src_dev_idx_fwd_ = pool_list_[trans.copy.src_idx_].agent_index_;
+        res.dst_dev_idx_fwd_ = pool_list_[trans.copy.dst_idx_].agent_index_;
+        res.src_agent_fwd_ = pool_list_[trans.copy.src_idx_].owner_agent_;
+        res.dst_agent_fwd_ = pool_list_[trans.copy.dst_idx_].owner_agent_;
+        res.buf_src_fwd_ = AcquireBuffer(trans.copy.src_pool_, max_size);
+        res.buf_dst_fwd_ = AcquireBuffer(trans.copy.dst_pool_, max_size * max_depth);
+        res.buffer_list_.push_back(res.buf_src_fwd_);
+        res.buffer_list_.push_back(res.buf_dst_fwd_);
+        AcquirePoolAcceses(res.src_dev_idx_fwd_, res.src_agent_fwd_, res.buf_src_fwd_,
+                           res.dst_dev_idx_fwd_, res.dst_agent_fwd_, res.buf_dst_fwd_);
+        for (uint32_t sidx = 0; sidx < max_depth; sidx++) {
+            res.signal_list_.push_back(AcquireSignal());
+        }
+
+        // Sweep queue depths for every size of copy
+        uint32_t size_len = size_list_.size();
+        uint32_t depth_len = queue_depth_list_.size();
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            for (uint32_t ddx = 0; ddx < depth_len; ddx++) {
+                iops_result_t result;
+                result.trans_idx_ = idx;
+                RunQueueDepthCopies(res, queue_depth_list_[ddx], size_list_[sdx], result);
+                iops_list_.push_back(result);
+                PrintProgress();
+            }
+        }
+
+        ReleaseCopyResources(res);
+    }
+}
+
+void RocmBandwidthTest::DisplayQueueDepthResults() const {
+    std::cout << std::endl;
+    std::cout << "Copies per second and latency (us) of small copies kept in flight" << std::endl;
+
+    uint32_t prev_idx = trans_list_.size();
+    uint32_t result_size = iops_list_.size();
+    for (uint32_t idx = 0; idx < result_size; idx++) {
+        const iops_result_t& result = iops_list_[idx];
+        const async_trans_t& trans = trans_list_[result.trans_idx_];
+        if (result.trans_idx_ != prev_idx) {
+            prev_idx = result.trans_idx_;
+            std::cout << std::endl;
+            std::cout << "  Src Pool " << trans.copy.src_idx_;
+            std::cout << " -> Dst Pool " << trans.copy.dst_idx_ << std::endl;
+            std::cout << std::setw(14) << "Size (B)";
+            std::cout << std::setw(8) << "Depth";
+            std::cout << std::setw(14) << "Copies/s";
+            std::cout << std::setw(12) << "p50";
+            std::cout << std::setw(12) << "p90";
+            std::cout << std::setw(12) << "p99";
+            std::cout << std::setw(12) << "Max" << std::endl;
+        }
+        std::cout << std::setw(14) << result.size_;
+        std::cout << std::setw(8) << result.depth_;
+        std::cout << std::setw(14) << std::fixed << std::setprecision(0) << result.copy_rate_;
+        std::cout << std::setprecision(3);
+        std::cout << std::setw(12) << result.lat_p50_;
+        std::cout << std::setw(12) << result.lat_p90_;
+        std::cout << std::setw(12) << result.lat_p99_;
+        std::cout << std::setw(12) << result.lat_max_ << std::endl;
+    }
+    std::cout << std::endl;
+}
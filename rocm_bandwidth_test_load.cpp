@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Bind buffers and a signal to copies from one pool to another
+static void BindLoadCopy(const vector<pool_info_t>& pool_list, uint32_t src_idx,
+                         uint32_t dst_idx, copy_resources_t& res) {
+    res.bidir_ = false;
+    res.src_dev_idx_fwd_ = pool_list[src_idx].agent_index_;
+    res.dst_dev_idx_fwd_ = pool_list[dst_idx].agent_index_;
+    res.src_agent_fwd_ = pool_list[src_idx].owner_agent_;
+    res.dst_agent_fwd_ = pool_list[dst_idx].owner_agent_;
+}
+
+void RocmBandwidthTest::RunBackgroundLoad(copy_resources_t& res, double duty,
+                                          std::atomic<bool>& stop, std::atomic<bool>& started,
+                                          uint64_t& byte_cnt, hsa_status_t& status) {
+    hsa_wait_state_t policy =
+        (bw_blocking_run_ == NULL) ? HSA_WAIT_STATE_ACTIVE : HSA_WAIT_STATE_BLOCKED;
+
+    // Copies are paced by idling for a share of the time every copy
+    // takes, leaving the link busy for the duty share of time. Errors
+    // end the copies and are checked by the thread that started them,
+    // as they can't be raised across threads
+    byte_cnt = 0;
+    status = HSA_STATUS_SUCCESS;
+    while (stop.load() == false) {
+        hsa_signal_store_relaxed(res.signal_fwd_, 1);
+        std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+        status = hsa_amd_memory_async_copy(res.buf_dst_fwd_, res.dst_agent_fwd_, res.buf_src_fwd_,
+                                           res.src_agent_fwd_, res.max_size_, 0, NULL,
+                                           res.signal_fwd_);
+        if (status != HSA_STATUS_SUCCESS) {
+            started.store(true);
+            return;
+        }
+        while (hsa_signal_wait_acquire(res.signal_fwd_, HSA_SIGNAL_CONDITION_LT, 1,
+                                       uint64_t(-1), policy))
+            ;
+        byte_cnt += res.max_size_;
+        started.store(true);
+        if (duty < 1) {
+            std::chrono::duration<double> copy_time = std::chrono::steady_clock::now() - start;
+            std::this_thread::sleep_for(copy_time * ((1 - duty) / duty));
+        }
+    }
+}
+
+void RocmBandwidthTest::RunLatencyUnderLoad() {
+    hsa_wait_state_t policy =
+        (bw_blocking_run_ == NULL) ? HSA_WAIT_STATE_ACTIVE : HSA_WAIT_STATE_BLOCKED;
+
+    // Bind resources of background copies loading the link
+    copy_resources_t load_res;
+    uint32_t load_src_idx = load_pair_[0];
+    uint32_t load_dst_idx = load_pair_[1];
+    BindLoadCopy(pool_list_, load_src_idx, load_dst_idx, load_res);
+    load_res.max_size_ = LOAD_BULK_SIZE;
+    AllocateCopyBuffers(LOAD_BULK_SIZE, load_res.buf_src_fwd_, pool_list_[load_src_idx].pool_,
+                        load_res.buf_dst_fwd_, pool_list_[load_dst_idx].pool_);
+    load_res.signal_fwd_ = AcquireSignal();
+    load_res.buffer_list_.push_back(load_res.buf_src_fwd_);
+    load_res.buffer_list_.push_back(load_res.buf_dst_fwd_);
+    load_res.signal_list_.push_back(load_res.signal_fwd_);
+    AcquirePoolAcceses(load_res.src_dev_idx_fwd_, load_res.src_agent_fwd_, load_res.buf_src_fwd_,
+                       load_res.dst_dev_idx_fwd_, load_res.dst_agent_fwd_, load_res.buf_dst_fwd_);
+
+    load_list_.clear();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if (trans.req_type_ != REQ_COPY_UNIDIR) {
+            continue;
+        }
+
+        // Bind resources of probe copies
+        copy_resources_t res;
+        BindLoadCopy(pool_list_, trans.copy.src_idx_, trans.copy.dst_idx_, res);
+        res.max_size_ = LOAD_PROBE_SIZE;
+        AllocateCopyBuffers(LOAD_PROBE_SIZE, res.buf_src_fwd_, trans.copy.src_pool_,
+                            res.buf_dst_fwd_, trans.copy.dst_pool_);
+        res.signal_fwd_ = AcquireSignal();
+        res.buffer_list_.push_back(res.buf_src_fwd_);
+        res.buffer_list_.push_back(res.buf_dst_fwd_);
+        res.signal_list_.push_back(res.signal_fwd_);
+        AcquirePoolAcceses(res.src_dev_idx_fwd_, res.src_agent_fwd_, res.buf_src_fwd_,
+                           res.dst_dev_idx_fwd_, res.dst_agent_fwd_, res.buf_dst_fwd_);
+
+        uint32_t level_len = load_level_list_.size();
+        for (uint32_t ldx = 0; ldx < level_len; ldx++) {
+            // Background copies run on a thread of their own until
+            // every probe has been timed
+            uint32_t level = load_level_list_[ldx];
+            std::atomic<bool> stop(false);
+            std::atomic<bool> started(false);
+            uint64_t byte_cnt = 0;
+            hsa_status_t load_status = HSA_STATUS_SUCCESS;
+            std::thread load_thread;
+            std::chrono::time_point<std::chrono::steady_clock> start =
+                std::chrono::steady_clock::now();
+            if (level > 0) {
+                load_thread = std::thread(&RocmBandwidthTest::RunBackgroundLoad, this,
+                                          std::ref(load_res), level / 100.0, std::ref(stop),
+                                          std::ref(started), std::ref(byte_cnt),
+                                          std::ref(load_status));
+
+                // Probes are timed only once the link carries load,
+                // i.e. the first background copy has completed
+                while (started.load() == false) {
+                    std::this_thread::yield();
+                }
+            }
+
+            vector<double> lat_list;
+            for (uint32_t pdx = 0; pdx < LOAD_PROBE_CNT; pdx++) {
+                hsa_signal_store_relaxed(res.signal_fwd_, 1);
+                std::chrono::time_point<std::chrono::steady_clock> issue =
+                    std::chrono::steady_clock::now();
+                err_ = hsa_amd_memory_async_copy(res.buf_dst_fwd_, res.dst_agent_fwd_,
+                                                 res.buf_src_fwd_, res.src_agent_fwd_,
+                                                 LOAD_PROBE_SIZE, 0, NULL, res.signal_fwd_);
+                if (err_ != HSA_STATUS_SUCCESS) {
+                    break;
+                }
+                while (hsa_signal_wait_acquire(res.signal_fwd_, HSA_SIGNAL_CONDITION_LT, 1,
+                                               uint64_t(-1), policy))
+                    ;
+                std::chrono::duration<double, std::micro> lat_time =
+                    std::chrono::steady_clock::now() - issue;
+                lat_list.push_back(lat_time.count());
+            }
+
+            // Errors of either thread are checked once background
+            // copies have stopped
+            stop.store(true);
+            if (load_thread.joinable()) {
+                load_thread.join();
+            }
+            ErrorCheck(err_);
+            ErrorCheck(load_status);
+            std::chrono::duration<double> run_time = std::chrono::steady_clock::now() - start;
+
+            load_result_t result;
+            result.trans_idx_ = idx;
+            result.level_ = level;
+            result.load_bandwidth_ = (double)byte_cnt / run_time.count() / 1000 / 1000 / 1000;
+            result.lat_p50_ = GetPercentileTime(lat_list, 50);
+            result.lat_p90_ = GetPercentileTime(lat_list, 90);
+            result.lat_p99_ = GetPercentileTime(lat_list, 99);
+            result.lat_max_ = lat_list.back();
+            load_list_.push_back(result);
+            PrintProgress();
+        }
+
+        ReleaseCopyResources(res);
+    }
+
+    ReleaseCopyResources(load_res);
+}
+
+void RocmBandwidthTest::DisplayLoadResults() const {
+    std::cout << std::endl;
+    std::cout << "Latency (us) of " << LOAD_PROBE_SIZE << " byte copies while Src Pool "
+              << load_pair_[0] << " -> Dst Pool " << load_pair_[1] << " is loaded" << std::endl;
+
+    uint32_t prev_idx = trans_list_.size();
+    uint32_t result_size = load_list_.size();
+    for (uint32_t idx = 0; idx < result_size; idx++) {
+        const load_result_t& result = load_list_[idx];
+        const async_trans_t& trans = trans_list_[result.trans_idx_];
+        if (result.trans_idx_ != prev_idx) {
+            prev_idx = result.trans_idx_;
+            std::cout << std::endl;
+            std::cout << "  Src Pool " << trans.copy.src_idx_;
+            std::cout << " -> Dst Pool " << trans.copy.dst_idx_ << std::endl;
+            std::cout << std::setw(10) << "Load (%)";
+            std::cout << std::setw(14) << "Load (GB/s)";
+            std::cout << std::setw(12) << "p50";
+            std::cout << std::setw(12) << "p90";
+            std::cout << std::setw(12) << "p99";
+            std::cout << std::setw(12) << "Max" << std::endl;
+        }
+        std::cout << std::setw(10) << result.level_;
+        std::cout << std::setw(14) << std::fixed << std::setprecision(3) << result.load_bandwidth_;
+        std::cout << std::setw(12) << result.lat_p50_;
+        std::cout << std::setw(12) << result.lat_p90_;
+        std::cout << std::setw(12) << result.lat_p99_;
+        std::cout << std::setw(12) << result.lat_max_ << std::endl;
+    }
+    std::cout << std::endl;
+}
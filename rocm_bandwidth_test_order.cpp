@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// A unit of execution of the order engine: copies of one size of a
+// transaction for one round of iterations
+typedef struct order_unit {
+        uint32_t trans_idx_;
+        uint32_t size_idx_;
+        uint32_t round_;
+
+} order_unit_t;
+
+bool RocmBandwidthTest::IsOrderedRun() const {
+    return (order_shuffle_ || order_interleave_sizes_ || order_interleave_rounds_ ||
+            (round_cnt_ > 1));
+}
+
+// @brief: Build the order in which units of copies are run. Rounds are
+// run one after another for each transaction unless interleaved, in
+// which case every transaction runs a round before any runs the next
+static void BuildOrder(uint32_t trans_cnt, uint32_t size_len, uint32_t round_cnt, bool shuffle,
+                       bool interleave_sizes, bool interleave_rounds, std::mt19937& engine,
+                       vector<order_unit_t>& unit_list) {
+    vector<uint32_t> trans_order(trans_cnt);
+    for (uint32_t idx = 0; idx < trans_cnt; idx++) {
+        trans_order[idx] = idx;
+    }
+    vector<uint32_t> size_order(size_len);
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        size_order[idx] = idx;
+    }
+    if (shuffle) {
+        std::shuffle(trans_order.begin(), trans_order.end(), engine);
+    }
+
+    uint32_t outer_cnt = (interleave_rounds) ? round_cnt : trans_cnt;
+    uint32_t inner_cnt = (interleave_rounds) ? trans_cnt : round_cnt;
+    for (uint32_t outer = 0; outer < outer_cnt; outer++) {
+        // Transactions are shuffled afresh for every round
+        if ((interleave_rounds) && (shuffle) && (outer != 0)) {
+            std::shuffle(trans_order.begin(), trans_order.end(), engine);
+        }
+        for (uint32_t inner = 0; inner < inner_cnt; inner++) {
+            if (interleave_sizes) {
+                std::shuffle(size_order.begin(), size_order.end(), engine);
+            }
+            order_unit_t unit;
+            unit.trans_idx_ = trans_order[(interleave_rounds) ? inner : outer];
+            unit.round_ = (interleave_rounds) ? outer : inner;
+            for (uint32_t idx = 0; idx < size_len; idx++) {
+                unit.size_idx_ = size_order[idx];
+                unit_list.push_back(unit);
+            }
+        }
+    }
+}
+
+void RocmBandwidthTest::RunOrderedCopies() {
+    // Collect indices of copy transactions, others are not reordered
+    vector<uint32_t> copy_list;
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        uint32_t req_type = trans_list_[idx].req_type_;
+        if ((req_type == REQ_COPY_BIDIR) || (req_type == REQ_COPY_UNIDIR) ||
+            (req_type == REQ_COPY_ALL_BIDIR) || (req_type == REQ_COPY_ALL_UNIDIR)) {
+            copy_list.push_back(idx);
+        }
+    }
+
+    uint32_t copy_cnt = copy_list.size();
+    uint32_t size_len = size_list_.size();
+    std::mt19937 engine(order_seed_);
+    vector<order_unit_t> unit_list;
+    BuildOrder(copy_cnt, size_len, round_cnt_, order_shuffle_, order_interleave_sizes_,
+               order_interleave_rounds_, engine, unit_list);
+
+    // Iterations are split among rounds, each round running one more
+    // iteration as the slowest copy of a round is dropped
+    uint32_t round_iter_cnt = ((num_iteration_ + round_cnt_ - 1) / round_cnt_) + 1;
+
+    // Copy times of every size of a transaction across its rounds and
+    // validation outcome of every size
+    vector<vector<double>> time_list(copy_cnt * size_len);
+    vector<bool> fwd_valid(copy_cnt * size_len, true);
+    vector<bool> rev_valid(copy_cnt * size_len, true);
+    for (uint32_t idx = 0; idx < copy_cnt; idx++) {
+        trans_list_[copy_list[idx]].round_time_.assign(size_len * round_cnt_, 0);
+    }
+
+    // Units run copies of different sizes, so buffer of the source
+    // pattern is allocated for the largest one up front
+    ReserveInitBuffer(size_list_.back());
+
+    uint32_t unit_cnt = unit_list.size();
+    for (uint32_t idx = 0; idx < unit_cnt; idx++) {
+        const order_unit_t& unit = unit_list[idx];
+        async_trans_t& trans = trans_list_[copy_list[unit.trans_idx_]];
+        size_t curr_size = size_list_[unit.size_idx_];
+        uint32_t time_idx = (unit.trans_idx_ * size_len) + unit.size_idx_;
+
+        // Buffers of a unit are sized for its copy, cache of buffers
+        // lets following units reuse them
+        copy_resources_t res;
+        AcquireCopyResources(trans, curr_size, res);
+        BindPaceRate(trans, res);
+        vector<double> cpu_time;
+        vector<double> gpu_time;
+        validate_pipeline_.ResetResults();
+        RunCopyIterations(trans, res, curr_size, round_iter_cnt, cpu_time, gpu_time);
+        if (validate_) {
+            fwd_valid[time_idx] = CollectDstValidation(curr_size, 0) && fwd_valid[time_idx];
+            if (res.bidir_) {
+                rev_valid[time_idx] = CollectDstValidation(curr_size, 1) && rev_valid[time_idx];
+            }
+        }
+        ReleaseCopyResources(res);
+
+        // Record average copy time of round and keep its copy times.
+        // Computing the average drops slowest copy of the round, i.e.
+        // its warm-up, so it is not kept among copies of all rounds
+        vector<double>& round_time = (print_cpu_time_) ? cpu_time : gpu_time;
+        if (round_time.size() != 0) {
+            trans.round_time_[(unit.size_idx_ * round_cnt_) + unit.round_] =
+                GetMeanTime(round_time);
+            vector<double>& all_time = time_list[time_idx];
+            all_time.insert(all_time.end(), round_time.begin(), round_time.end());
+        }
+    }
+
+    // Statistics of every size are computed over copies of all rounds
+    for (uint32_t idx = 0; idx < copy_cnt; idx++) {
+        async_trans_t& trans = trans_list_[copy_list[idx]];
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            uint32_t time_idx = (idx * size_len) + sdx;
+            if (validate_) {
+                trans.fwd_valid_.push_back(fwd_valid[time_idx]);
+                if (trans.copy.bidir_) {
+                    trans.rev_valid_.push_back(rev_valid[time_idx]);
+                }
+            }
+            // Warm-up of every round is already dropped, so the slowest
+            // copy is repeated in place of the one CollectCopyTime drops
+            vector<double>& all_time = time_list[time_idx];
+            if (all_time.size() != 0) {
+                all_time.push_back(GetMaxTime(all_time));
+                CollectCopyTime(trans, all_time, all_time);
+            }
+        }
+        ComputeCopyTime(trans);
+        EmitResults(trans);
+    }
+}
+
+void RocmBandwidthTest::DisplayRoundResults() const {
+    std::cout << std::endl;
+    std::cout << "Bandwidth (GB/s) of every round";
+    if (order_shuffle_ || order_interleave_sizes_) {
+        std::cout << ", order seed " << order_seed_;
+    }
+    std::cout << std::endl;
+
+    uint32_t size_len = size_list_.size();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if (trans.round_bandwidth_.size() == 0) {
+            continue;
+        }
+        std::cout << std::endl;
+        std::cout << "  Src Pool " << trans.copy.src_idx_;
+        std::cout << ((trans.copy.bidir_) ? " <-> " : " -> ");
+        std::cout << "Dst Pool " << trans.copy.dst_idx_ << std::endl;
+        std::cout << std::setw(14) << "Size (MB)";
+        for (uint32_t rdx = 0; rdx < round_cnt_; rdx++) {
+            std::cout << std::setw(10) << ("R" + std::to_string(rdx));
+        }
+        std::cout << std::endl;
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            std::cout << std::setw(14) << std::fixed << std::setprecision(3)
+                      << ((double)size_list_[sdx] / (1024 * 1024));
+            for (uint32_t rdx = 0; rdx < round_cnt_; rdx++) {
+                std::cout << std::setw(10) << trans.round_bandwidth_[(sdx * round_cnt_) + rdx];
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
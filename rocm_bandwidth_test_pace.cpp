@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+// Parse a rate given in GB/s, or as a duty cycle if it ends in '%'
+static bool ParsePaceRate(const std::string& value, pace_spec_t& spec) {
+    if (value.empty()) {
+        return false;
+    }
+    spec.duty_ = (value.back() == '%');
+    std::string num = (spec.duty_) ? value.substr(0, value.size() - 1) : value;
+    char* end = NULL;
+    spec.rate_ = strtod(num.c_str(), &end);
+    if ((num.empty()) || (*end != '\0') || (spec.rate_ <= 0)) {
+        return false;
+    }
+    if ((spec.duty_) && (spec.rate_ > 100)) {
+        return false;
+    }
+    return true;
+}
+
+void RocmBandwidthTest::BuildPaceList() {
+    // Gap is given in units of 10 microseconds and can't be
+    // combined with rates, as both pace the same copies
+    pace_gap_ = 0;
+    if (bw_sleep_time_ != NULL) {
+        int32_t sleep_time = atoi(bw_sleep_time_);
+        if ((sleep_time < 0) || (sleep_time > 400000)) {
+            std::cout << "Unit of sleep time is defined as 10 microseconds" << std::endl;
+            std::cout << "An input value of 10 implies sleep time of 100 microseconds" << std::endl;
+            std::cout << "Value of ROCM_BW_SLEEP_TIME must be between [1, 400000]" << sleep_time
+                      << std::endl;
+            ExitOrRaise(1);
+        }
+        if (bw_rate_ != NULL) {
+            std::cout << "ROCM_BW_SLEEP_TIME can't be combined with ROCM_BW_RATE" << std::endl;
+            ExitOrRaise(1);
+        }
+        pace_gap_ = sleep_time * 10 / 1e6;
+    }
+
+    if (bw_rate_ == NULL) {
+        return;
+    }
+
+    // Rates are separated by commas, each either applying to all
+    // copies or to copies from a pool to another as src:dst=rate
+    std::stringstream stream(bw_rate_);
+    std::string token;
+    while (std::getline(stream, token, ',')) {
+        pace_spec_t spec;
+        spec.any_ = true;
+        spec.src_idx_ = 0;
+        spec.dst_idx_ = 0;
+        std::string value = token;
+        size_t eq_pos = token.find('=');
+        if (eq_pos != std::string::npos) {
+            size_t sep_pos = token.find(':');
+            if ((sep_pos == std::string::npos) || (sep_pos > eq_pos)) {
+                std::cout << "Invalid value of ROCM_BW_RATE: " << token << std::endl;
+                ExitOrRaise(1);
+            }
+            spec.any_ = false;
+            spec.src_idx_ = atoi(token.substr(0, sep_pos).c_str());
+            spec.dst_idx_ = atoi(token.substr(sep_pos + 1, eq_pos - sep_pos - 1).c_str());
+            value = token.substr(eq_pos + 1);
+        }
+        if (ParsePaceRate(value, spec) == false) {
+            std::cout << "Invalid value of ROCM_BW_RATE: " << token << std::endl;
+            ExitOrRaise(1);
+        }
+        pace_list_.push_back(spec);
+    }
+}
+
+void RocmBandwidthTest::BindPaceRate(async_trans_t& trans, copy_resources_t& res) {
+    // Bucket of a gap fills in seconds per second and is not
+    // reported as a rate
+    trans.pace_rate_ = 0;
+    trans.pace_duty_ = false;
+    res.pace_gap_ = pace_gap_;
+    if (pace_gap_ > 0) {
+        res.pace_duty_ = true;
+        res.pace_rate_ = 1;
+        return;
+    }
+
+    // Rate of a pair of pools takes precedence over rate of all copies
+    uint32_t pace_len = pace_list_.size();
+    for (uint32_t idx = 0; idx < pace_len; idx++) {
+        const pace_spec_t& spec = pace_list_[idx];
+        bool match = ((spec.src_idx_ == trans.copy.src_idx_) &&
+                      (spec.dst_idx_ == trans.copy.dst_idx_));
+        if ((spec.any_) && (trans.pace_rate_ == 0)) {
+            trans.pace_rate_ = spec.rate_;
+            trans.pace_duty_ = spec.duty_;
+        }
+        if ((spec.any_ == false) && (match)) {
+            trans.pace_rate_ = spec.rate_;
+            trans.pace_duty_ = spec.duty_;
+            break;
+        }
+    }
+
+    // Bucket fills in bytes per second or in busy seconds per second
+    res.pace_duty_ = trans.pace_duty_;
+    res.pace_rate_ = (trans.pace_duty_) ? (trans.pace_rate_ / 100)
+                                        : (trans.pace_rate_ * 1000 * 1000 * 1000);
+}
+
+void RocmBandwidthTest::ResetPacer(copy_resources_t& res) {
+    // Gap also applies before the first copy
+    res.pace_tokens_ = -res.pace_gap_;
+    res.pace_cost_ = 0;
+    res.pace_start_ = std::chrono::steady_clock::now();
+    res.pace_last_ = res.pace_start_;
+}
+
+void RocmBandwidthTest::WaitForPacer(copy_resources_t& res) {
+    if (res.pace_rate_ == 0) {
+        return;
+    }
+
+    // Bucket holds no credit beyond what is needed to start a copy,
+    // so time spent outside of copies does not allow a burst later
+    std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> fill_time = now - res.pace_last_;
+    res.pace_tokens_ = std::min(0.0, res.pace_tokens_ + (res.pace_rate_ * fill_time.count()));
+    res.pace_last_ = now;
+    if (res.pace_tokens_ < 0) {
+        std::chrono::duration<double> wait_time(-res.pace_tokens_ / res.pace_rate_);
+        std::this_thread::sleep_for(wait_time);
+        res.pace_tokens_ = 0;
+        res.pace_last_ = std::chrono::steady_clock::now();
+    }
+}
+
+void RocmBandwidthTest::ChargePacer(copy_resources_t& res, size_t size,
+                                    std::chrono::time_point<std::chrono::steady_clock> copy_start) {
+    if (res.pace_rate_ == 0) {
+        return;
+    }
+
+    // Gap is counted from the end of a copy
+    if (res.pace_gap_ > 0) {
+        res.pace_tokens_ -= res.pace_gap_;
+        res.pace_last_ = std::chrono::steady_clock::now();
+        return;
+    }
+
+    // Cost of a copy is its size, or the time it kept the link busy
+    double cost = (double)size;
+    if (res.pace_duty_) {
+        std::chrono::duration<double> busy_time = std::chrono::steady_clock::now() - copy_start;
+        cost = busy_time.count();
+    }
+    res.pace_tokens_ -= cost;
+    res.pace_cost_ += cost;
+}
+
+double RocmBandwidthTest::GetPacedRate(copy_resources_t& res) {
+    // Achieved rate in units of requested rate, GB/s or percent
+    std::chrono::duration<double> run_time = std::chrono::steady_clock::now() - res.pace_start_;
+    double rate = res.pace_cost_ / run_time.count();
+    return (res.pace_duty_) ? (rate * 100) : (rate / 1000 / 1000 / 1000);
+}
+
+void RocmBandwidthTest::DisplayPacingResults() const {
+    std::cout << std::endl;
+    std::cout << "Requested and achieved rate of paced copies" << std::endl;
+
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if (trans.pace_achieved_.size() == 0) {
+            continue;
+        }
+        std::cout << std::endl;
+        std::cout << "  Src Pool " << trans.copy.src_idx_;
+        std::cout << ((trans.copy.bidir_) ? " <-> " : " -> ");
+        std::cout << "Dst Pool " << trans.copy.dst_idx_;
+        std::cout << ((trans.pace_duty_) ? ", duty cycle (%)" : ", GB/s") << std::endl;
+        std::cout << std::setw(14) << "Size (MB)";
+        std::cout << std::setw(14) << "Requested";
+        std::cout << std::setw(14) << "Achieved";
+        std::cout << std::setw(14) << "Error (%)" << std::endl;
+        uint32_t size_len = trans.pace_achieved_.size();
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            double achieved = trans.pace_achieved_[sdx];
+            std::cout << std::setw(14) << std::fixed << std::setprecision(3)
+                      << ((double)size_list_[sdx] / (1024 * 1024));
+            std::cout << std::setw(14) << trans.pace_rate_;
+            std::cout << std::setw(14) << achieved;
+            std::cout << std::setw(14) << ((achieved - trans.pace_rate_) / trans.pace_rate_ * 100)
+                      << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
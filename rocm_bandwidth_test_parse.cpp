@@ -42,6 +42,7 @@
 
 #include "common.hpp"
 #include "rocm_bandwidth_test.hpp"
+#include "size_spec.hpp"
 
 #include <assert.h>
 #include <unistd.h>
@@ -117,7 +118,14 @@ void RocmBandwidthTest::ValidateCopyBidirFlags(uint32_t copy_ctrl_mask) {
     // It is illegal to specify following flags
     // secondary flag that affects a copy operation
     if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & CPU_VISIBLE_TIME) ||
-        (copy_ctrl_mask & VALIDATE_COPY_OP)) {
+        (copy_ctrl_mask & COPY_QUEUE_DEPTH) || (copy_ctrl_mask & COPY_UNDER_LOAD)) {
+        PrintHelpScreen();
+        exit(0);
+    }
+
+    // Size search uses its own sizes
+    if ((copy_ctrl_mask & COPY_SIZE_SEARCH) &&
+        (copy_ctrl_mask & ~(COPY_SIZE_SEARCH | USR_BUFFER_INIT))) {
         PrintHelpScreen();
         exit(0);
     }
@@ -131,21 +139,37 @@ void RocmBandwidthTest::ValidateCopyUnidirFlags(uint32_t copy_mask, uint32_t cop
         exit(0);
     }
 
-    if ((copy_ctrl_mask & DEV_COPY_LATENCY) && (copy_ctrl_mask & USR_BUFFER_SIZE)) {
+    // It is illegal to specify Latency and another
+    // secondary flag that affects a copy operation
+    if ((copy_ctrl_mask & DEV_COPY_LATENCY) && (copy_ctrl_mask & VALIDATE_COPY_OP)) {
         PrintHelpScreen();
         exit(0);
     }
 
-    // It is illegal to specify Latency and another
-    // secondary flag that affects a copy operation
-    if ((copy_ctrl_mask & DEV_COPY_LATENCY) && (copy_ctrl_mask & VALIDATE_COPY_OP)) {
+    // Streams are timed by Gpu and can't measure latency
+    if ((copy_ctrl_mask & COPY_STREAMS) &&
+        ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & CPU_VISIBLE_TIME))) {
         PrintHelpScreen();
         exit(0);
     }
 
-    // It is illegal to specify user buffer sizes and another
-    // secondary flag that affects a copy operation
-    if ((copy_ctrl_mask & USR_BUFFER_SIZE) && (copy_ctrl_mask & VALIDATE_COPY_OP)) {
+    // Queue depth sweep uses its own sizes and timing
+    if ((copy_ctrl_mask & COPY_QUEUE_DEPTH) &&
+        (copy_ctrl_mask & ~(COPY_QUEUE_DEPTH | USR_BUFFER_INIT | USR_BUFFER_SIZE))) {
+        PrintHelpScreen();
+        exit(0);
+    }
+
+    // Size search uses its own sizes
+    if ((copy_ctrl_mask & COPY_SIZE_SEARCH) &&
+        (copy_ctrl_mask & ~(COPY_SIZE_SEARCH | USR_BUFFER_INIT | CPU_VISIBLE_TIME))) {
+        PrintHelpScreen();
+        exit(0);
+    }
+
+    // Probes under load use their own size and timing
+    if ((copy_ctrl_mask & COPY_UNDER_LOAD) &&
+        (copy_ctrl_mask & ~(COPY_UNDER_LOAD | USR_BUFFER_INIT))) {
         PrintHelpScreen();
         exit(0);
     }
@@ -157,8 +181,9 @@ void RocmBandwidthTest::ValidateCopyUnidirFlags(uint32_t copy_mask, uint32_t cop
 void RocmBandwidthTest::ValidateCopyAllBidirFlags(uint32_t copy_ctrl_mask) {
     // It is illegal to specify following flags
     // secondary flag that affects a copy operation
-    if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_SIZE) ||
-        (copy_ctrl_mask & CPU_VISIBLE_TIME) || (copy_ctrl_mask & VALIDATE_COPY_OP)) {
+    if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & CPU_VISIBLE_TIME) ||
+        (copy_ctrl_mask & COPY_STREAMS) || (copy_ctrl_mask & COPY_QUEUE_DEPTH) ||
+        (copy_ctrl_mask & COPY_UNDER_LOAD) || (copy_ctrl_mask & COPY_SIZE_SEARCH)) {
         PrintHelpScreen();
         exit(0);
     }
@@ -170,7 +195,9 @@ void RocmBandwidthTest::ValidateCopyAllBidirFlags(uint32_t copy_ctrl_mask) {
 void RocmBandwidthTest::ValidateCopyAllUnidirFlags(uint32_t copy_ctrl_mask) {
     // It is illegal to specify following flags
     // secondary flag that affects a copy operation
-    if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_SIZE)) {
+    if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & COPY_STREAMS) ||
+        (copy_ctrl_mask & COPY_QUEUE_DEPTH) || (copy_ctrl_mask & COPY_UNDER_LOAD) ||
+        (copy_ctrl_mask & COPY_SIZE_SEARCH)) {
         PrintHelpScreen();
         exit(0);
     }
@@ -232,15 +259,22 @@ void RocmBandwidthTest::ValidateInputFlags(uint32_t pf_cnt, uint32_t copy_mask,
 
     // Input is requesting to run concurrent copies
     // rocm_bandwidth_test -k or -K
-    // It is illegal to specify secondary flags
+    // It is illegal to specify secondary flags other than -v and -m
     if ((req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
         (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR)) {
         if ((copy_ctrl_mask & DEV_COPY_LATENCY) || (copy_ctrl_mask & USR_BUFFER_INIT) ||
-            (copy_ctrl_mask & USR_BUFFER_SIZE) || (copy_ctrl_mask & CPU_VISIBLE_TIME) ||
-            (copy_ctrl_mask & VALIDATE_COPY_OP)) {
+            (copy_ctrl_mask & CPU_VISIBLE_TIME) || (copy_ctrl_mask & COPY_STREAMS) ||
+            (copy_ctrl_mask & COPY_QUEUE_DEPTH) || (copy_ctrl_mask & COPY_UNDER_LOAD) ||
+            (copy_ctrl_mask & COPY_SIZE_SEARCH)) {
             PrintHelpScreen();
             exit(0);
         }
+
+        // Concurrent copies are not paced
+        if (pace_list_.size() != 0) {
+            std::cout << "ROCM_BW_RATE can't be combined with concurrent copies" << std::endl;
+            exit(1);
+        }
         return;
     }
 
@@ -264,12 +298,8 @@ void RocmBandwidthTest::BuildDeviceList() {
 }
 
 void RocmBandwidthTest::BuildBufferList() {
-    // User has specified buffer sizes to be used
+    // User has specified buffer sizes to be used, already in bytes
     if (size_list_.size() != 0) {
-        uint32_t size_len = size_list_.size();
-        for (uint32_t idx = 0; idx < size_len; idx++) {
-            size_list_[idx] = size_list_[idx] * 1024 * 1024;
-        }
         return;
     }
 
@@ -285,7 +315,7 @@ void RocmBandwidthTest::BuildBufferList() {
         }
 
         if (req_copy_unidir_ == REQ_COPY_UNIDIR) {
-            if (latency_) {
+            if ((latency_) || (queue_depth_list_.size() != 0)) {
                 size_list_.push_back(LATENCY_SIZE_LIST[idx]);
             } else if (validate_) {
                 if (idx == 16) {
@@ -320,7 +350,8 @@ void RocmBandwidthTest::ParseArguments() {
 
     int opt;
     bool status;
-    while ((opt = getopt(usr_argc_, usr_argv_, "hqteclvaAb:i:s:d:r:w:m:k:K:")) != -1) {
+    const char* opt_str = "hqteclvaAgb:i:s:d:r:w:m:k:K:f:o:C:S:D:B:n:Q:L:z:";
+    while ((opt = getopt(usr_argc_, usr_argv_, opt_str)) != -1) {
         switch (opt) {
             // Print help screen
             case 'h':
@@ -351,12 +382,76 @@ void RocmBandwidthTest::ParseArguments() {
                 req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
                 break;
 
+            // Compare copies between pools of every grain of all devices
+            case 'g':
+                num_primary_flags++;
+                req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
+                grain_compare_ = true;
+                break;
+
             // Enable Bidirectional copy among all valid buffers
             case 'A':
                 num_primary_flags++;
                 req_copy_all_bidir_ = REQ_COPY_ALL_BIDIR;
                 break;
 
+            // Check health of all links within a time budget in seconds
+            case 'B': {
+                num_primary_flags++;
+                req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
+                char* end = NULL;
+                health_budget_ = strtod(optarg, &end);
+                if ((*end != '\0') || (health_budget_ <= 0)) {
+                    print_help = true;
+                }
+                break;
+            }
+
+            // Run copies as one up to the given number of concurrent streams
+            case 'n': {
+                int32_t num = atoi(optarg);
+                if (num <= 0) {
+                    print_help = true;
+                    break;
+                }
+                stream_cnt_ = num;
+                copy_ctrl_mask |= COPY_STREAMS;
+                break;
+            }
+
+            // Collect list of queue depths at which small copies are kept in flight
+            case 'Q':
+                status = ParseOptionValue(optarg, queue_depth_list_);
+                if ((status == false) || (std::count(queue_depth_list_.begin(),
+                                                     queue_depth_list_.end(), 0) != 0)) {
+                    print_help = true;
+                    break;
+                }
+                copy_ctrl_mask |= COPY_QUEUE_DEPTH;
+                break;
+
+            // Collect shares of peak bandwidth in percent to search sizes for
+            case 'z':
+                status = ParseOptionValue(optarg, search_pct_list_);
+                if ((status == false) ||
+                    (std::count(search_pct_list_.begin(), search_pct_list_.end(), 0) != 0) ||
+                    (*std::max_element(search_pct_list_.begin(), search_pct_list_.end()) > 100)) {
+                    print_help = true;
+                    break;
+                }
+                copy_ctrl_mask |= COPY_SIZE_SEARCH;
+                break;
+
+            // Collect pools of link loaded by background copies
+            case 'L':
+                status = ParseOptionValue(optarg, load_pair_);
+                if ((status == false) || (load_pair_.size() != 2)) {
+                    print_help = true;
+                    break;
+                }
+                copy_ctrl_mask |= COPY_UNDER_LOAD;
+                break;
+
             // Collect list of source buffers involved in unidirectional copy operation
             case 's':
                 status = ParseOptionValue(optarg, src_list_);
@@ -409,14 +504,17 @@ void RocmBandwidthTest::ParseArguments() {
                 break;
 
             // Size of buffers to use in copy and read/write operations
-            case 'm':
-                status = ParseOptionValue(optarg, size_list_);
+            case 'm': {
+                std::string error;
+                status = ParseSizeSpec(optarg, 1024 * 1024, size_list_, error);
                 if (status == false) {
+                    std::cout << "Error: Invalid size list, " << error << std::endl;
                     print_help = true;
                     break;
                 }
                 copy_ctrl_mask |= USR_BUFFER_SIZE;
                 break;
+            }
 
             // Print Cpu time
             case 'c':
@@ -446,6 +544,34 @@ void RocmBandwidthTest::ParseArguments() {
                 copy_ctrl_mask |= USR_BUFFER_INIT;
                 break;
 
+            // Format in which to emit results
+            case 'f':
+                sink_format_ = GetSinkFormat(optarg);
+                if (sink_format_ == SINK_FORMAT_INVALID) {
+                    print_help = true;
+                }
+                break;
+
+            // File to write results into
+            case 'o':
+                sink_path_ = optarg;
+                break;
+
+            // File of baseline results to compare against
+            case 'C':
+                baseline_path_ = optarg;
+                break;
+
+            // File of scenarios to run in one session
+            case 'S':
+                scenario_path_ = optarg;
+                break;
+
+            // Socket to serve requests on as a daemon
+            case 'D':
+                daemon_path_ = optarg;
+                break;
+
             // Collect request to read a buffer
             case 'r':
                 req_read_ = REQ_READ;
@@ -470,9 +596,11 @@ void RocmBandwidthTest::ParseArguments() {
             case '?':
                 std::cout << "Argument is illegal or needs value: " << '?' << std::endl;
                 if ((optopt == 'b') || (optopt == 's') || (optopt == 'd') || (optopt == 'm') ||
-                    (optopt == 'i') || (false)) {
-                    std::cout << "Error: Options -b -s -d -m -i -k and -K require argument"
-                              << std::endl;
+                    (optopt == 'i') || (optopt == 'f') || (optopt == 'o') || (optopt == 'C') ||
+                    (optopt == 'S') || (optopt == 'D') || (optopt == 'B') || (optopt == 'n') ||
+                    (optopt == 'Q') || (optopt == 'L') || (optopt == 'z')) {
+                    std::cout << "Error: Options -b -s -d -m -i -k -K -f -o -C -S -D -B -n -Q "
+                              << "-L and -z require argument" << std::endl;
                 }
                 print_help = true;
                 break;
@@ -488,15 +616,65 @@ void RocmBandwidthTest::ParseArguments() {
         exit(0);
     }
 
+    // Daemon receives settings of copies with every request. Roc
+    // Runtime is initialized and topology discovered only once, or
+    // not at all if requests are served by a stub whose copies are
+    // timed as if by the Cpu
+    if (daemon_path_ != NULL) {
+        if ((num_primary_flags != 0) || (copy_ctrl_mask != 0) || (scenario_path_ != NULL)) {
+            PrintHelpScreen();
+            exit(0);
+        }
+        if (bw_daemon_stub_ == NULL) {
+            err_ = hsa_init();
+            ErrorCheck(err_);
+            DiscoverTopology();
+        } else {
+            print_cpu_time_ = true;
+            BuildStubTopology();
+        }
+        return;
+    }
+
+    // Scenario file replaces primary flags and flags that control
+    // copies. Roc Runtime is initialized but topology is discovered
+    // as scenarios are run, using their filters on grain of pools
+    if (scenario_path_ != NULL) {
+        if ((num_primary_flags != 0) || (copy_ctrl_mask != 0)) {
+            PrintHelpScreen();
+            exit(0);
+        }
+        std::string error;
+        if (ParseScenarioFile(scenario_path_, scenario_list_, error) == false) {
+            std::cout << "Invalid scenario file " << scenario_path_ << ": " << error << std::endl;
+            exit(1);
+        }
+        err_ = hsa_init();
+        ErrorCheck(err_);
+        return;
+    }
+
     // Determine input of primary flags is valid
     ValidateInputFlags(num_primary_flags, copy_mask, copy_ctrl_mask);
 
-    // Initialize Roc Runtime
-    err_ = hsa_init();
-    ErrorCheck(err_);
+    // Printing of topology can be served from a snapshot
+    // without initializing Roc Runtime if user has requested
+    bool offline = ((bw_topology_offline_ != NULL) &&
+                    ((req_list_devs_ == REQ_LIST_DEVS) || (req_topology_ == REQ_TOPOLOGY)));
+    if (offline) {
+        if (LoadTopologySnapshot(true) == false) {
+            std::cout << "Unable to load topology snapshot named by ROCM_BW_TOPOLOGY_CACHE"
+                      << std::endl;
+            exit(1);
+        }
+    } else {
+        // Initialize Roc Runtime
+        err_ = hsa_init();
+        ErrorCheck(err_);
 
-    // Discover the topology of RocR agent in system
-    DiscoverTopology();
+        // Discover the topology of RocR agent in system
+        DiscoverTopology();
+    }
 
     // Print list of devices if user option is "-e"
     if (req_list_devs_ == REQ_LIST_DEVS) {
@@ -45,6 +45,7 @@
 
 #include <assert.h>
 
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -63,7 +64,8 @@ void RocmBandwidthTest::PrintHelpScreen() {
     std::cout << "\t -i    Initialize copy buffer with specified 'long double' pattern"
               << std::endl;
     std::cout << "\t -t    Prints system topology and allocatable memory info" << std::endl;
-    std::cout << "\t -m    List of buffer sizes to use, specified in Megabytes" << std::endl;
+    std::cout << "\t -m    List of buffer sizes to use, in Megabytes or with suffix B, K, M or G,"
+              << " and ranges such as 4K:1G:x2 or 1M:64M:+1M" << std::endl;
     std::cout << "\t -b    List devices to use in bidirectional copy operations" << std::endl;
     std::cout << "\t -s    List of source devices to use in copy unidirectional operations"
               << std::endl;
@@ -73,13 +75,38 @@ void RocmBandwidthTest::PrintHelpScreen() {
               << std::endl;
     std::cout << "\t -A    Perform Bidirectional Copy involving all device combinations"
               << std::endl;
+    std::cout << "\t -g    Perform Unidirectional Copy among pools of every grain of all devices"
+              << std::endl;
+    std::cout << "\t -f    Format of copy results: table, json, csv or ndjson" << std::endl;
+    std::cout << "\t -o    File to write copy results into, console output is retained"
+              << std::endl;
+    std::cout << "\t -C    Compare copy results against a baseline written by -f json or ndjson"
+              << std::endl;
+    std::cout << "\t -S    Run the scenarios listed in a scenario file in one session"
+              << std::endl;
+    std::cout << "\t -D    Run as a daemon serving requests on the named Unix socket"
+              << std::endl;
+    std::cout << "\t -B    Check health of all links within a time budget in seconds"
+              << std::endl;
+    std::cout << "\t -n    Run copies of -s x -d y or -b as 1 up to n concurrent streams"
+              << std::endl;
+    std::cout << "\t -Q    List of queue depths at which small copies of -s x -d y are kept"
+              << " in flight" << std::endl;
+    std::cout << "\t -L    Pair of devices whose link is loaded while timing small copies of"
+              << " -s x -d y" << std::endl;
+    std::cout << "\t -z    List of shares of peak bandwidth in percent to search sizes of"
+              << " -s x -d y or -b for" << std::endl;
     std::cout << std::endl;
 
     std::cout << "\t NOTE: Mixing following options is illegal/unsupported" << std::endl;
-    std::cout << "\t\t Case 1: rocm_bandwidth_test -a with {lm}{1,}" << std::endl;
-    std::cout << "\t\t Case 2: rocm_bandwidth_test -b with {clv}{1,}" << std::endl;
-    std::cout << "\t\t Case 3: rocm_bandwidth_test -A with {clmv}{1,}" << std::endl;
-    std::cout << "\t\t Case 4: rocm_bandwidth_test -s x -d y with {lmv}{2,}" << std::endl;
+    std::cout << "\t\t Case 1: rocm_bandwidth_test -a with {l}{1,}" << std::endl;
+    std::cout << "\t\t Case 2: rocm_bandwidth_test -b with {cl}{1,}" << std::endl;
+    std::cout << "\t\t Case 3: rocm_bandwidth_test -A with {cl}{1,}" << std::endl;
+    std::cout << "\t\t Case 4: rocm_bandwidth_test -s x -d y with {lv}{2,}" << std::endl;
+    std::cout << "\t\t Case 5: rocm_bandwidth_test -n with {acl}{1,}" << std::endl;
+    std::cout << "\t\t Case 6: rocm_bandwidth_test -Q with {clnv}{1,}" << std::endl;
+    std::cout << "\t\t Case 7: rocm_bandwidth_test -L with {clmnvQ}{1,}" << std::endl;
+    std::cout << "\t\t Case 8: rocm_bandwidth_test -z with {lmnvQL}{1,}" << std::endl;
     std::cout << std::endl;
 
     std::cout << std::endl;
@@ -129,6 +156,51 @@ void RocmBandwidthTest::PrintVersion() const {
     PrintLaunchCmd();
 }
 
+// @brief: Print time spent discovering topology. Time saved by
+// discovering access and link properties on first use is estimated
+// from the mean time taken to discover those of a pair of agents.
+// Only pairs whose discovery queries Roc Runtime are counted
+void RocmBandwidthTest::PrintSetupTime() const {
+    uint32_t access_pair_cnt = 0;
+    uint32_t link_pair_cnt = 0;
+    for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
+        for (uint32_t idx2 = 0; idx2 < agent_index_; idx2++) {
+            if (agent_pool_list_[idx2].pool_list.size() == 0) {
+                continue;
+            }
+            if (agent_pool_list_[idx1].pool_list.size() != 0) {
+                access_pair_cnt++;
+            }
+            if (idx1 != idx2) {
+                link_pair_cnt++;
+            }
+        }
+    }
+    double discovery_ms = setup_time_.discovery_time_.count() / 1e6;
+    double access_ms = setup_time_.access_time_.count() / 1e6;
+    double link_ms = setup_time_.link_time_.count() / 1e6;
+
+    double saved_ms = 0;
+    if (setup_time_.access_cnt_ != 0) {
+        saved_ms += (access_ms / setup_time_.access_cnt_) *
+                    (access_pair_cnt - setup_time_.access_cnt_);
+    }
+    if (setup_time_.link_cnt_ != 0) {
+        saved_ms += (link_ms / setup_time_.link_cnt_) * (link_pair_cnt - setup_time_.link_cnt_);
+    }
+
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Setup time to discover agents and pools (ms): " << discovery_ms << std::endl;
+    std::cout << "Setup time to discover access (ms):           " << access_ms << " for "
+              << setup_time_.access_cnt_ << " of " << access_pair_cnt << " agent pairs"
+              << std::endl;
+    std::cout << "Setup time to discover link properties (ms):  " << link_ms << " for "
+              << setup_time_.link_cnt_ << " of " << link_pair_cnt << " agent pairs" << std::endl;
+    std::cout << "Setup time saved by lazy discovery (ms):      " << saved_ms << std::endl;
+    std::cout << std::endl;
+}
+
 // @brief: Print the topology of Memory Pools and Devices present in system
 void RocmBandwidthTest::PrintTopology() {
     uint32_t format = 10;
@@ -192,6 +264,11 @@ void RocmBandwidthTest::PrintTopology() {
 std::string GetValueAsString(uint32_t key, uint32_t value) {
     std::stringstream ss;
 
+    // Pair of agents not discovered by run that saved a snapshot
+    if (value == RocmBandwidthTest::LINK_PROP_UNKNOWN) {
+        return std::string("?");
+    }
+
     switch (key) {
         case RocmBandwidthTest::LINK_PROP_ACCESS:
             ss << value;
@@ -264,21 +341,7 @@ void RocmBandwidthTest::PrintLinkPropsMatrix(uint32_t key) const {
         std::cout.width(format);
         std::cout << src_idx;
         for (uint32_t dst_idx = 0; dst_idx < agent_index_; dst_idx++) {
-            uint32_t value = 0x00;
-            switch (key) {
-                case LINK_PROP_ACCESS:
-                    value = direct_access_matrix_[(src_idx * agent_index_) + dst_idx];
-                    break;
-                case LINK_PROP_TYPE:
-                    value = link_type_matrix_[(src_idx * agent_index_) + dst_idx];
-                    break;
-                case LINK_PROP_HOPS:
-                    value = link_hops_matrix_[(src_idx * agent_index_) + dst_idx];
-                    break;
-                case LINK_PROP_WEIGHT:
-                    value = link_weight_matrix_[(src_idx * agent_index_) + dst_idx];
-                    break;
-            }
+            uint32_t value = GetLinkProp(key, src_idx, dst_idx);
             std::cout.width(format);
             std::cout << GetValueAsString(key, value);
         }
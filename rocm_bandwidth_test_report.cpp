@@ -44,25 +44,30 @@
 #include "rocm_bandwidth_test.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 
-static void printRecord(size_t size, double avg_time, double avg_bandwidth, double min_time,
-                        double peak_bandwidth) {
+// Sizes are printed in the largest unit that divides them
+static std::string getSizeString(size_t size) {
     std::stringstream size_str;
-    if (size < 1024) {
-        size_str << size << " Bytes";
-    } else if (size < 1024 * 1024) {
+    if ((size >= 1024 * 1024) && ((size % (1024 * 1024)) == 0)) {
+        size_str << size / (1024 * 1024) << " MB";
+    } else if ((size >= 1024) && ((size % 1024) == 0)) {
         size_str << size / 1024 << " KB";
     } else {
-        size_str << size / (1024 * 1024) << " MB";
+        size_str << size << " Bytes";
     }
+    return size_str.str();
+}
 
+static void printRecord(size_t size, double avg_time, double avg_bandwidth, double min_time,
+                        double peak_bandwidth, const std::string& status) {
     uint32_t format = 15;
     std::cout.precision(3);
     std::cout << std::fixed;
     std::cout.width(format);
-    std::cout << size_str.str();
+    std::cout << getSizeString(size);
     std::cout.width(format);
     std::cout << (avg_time * 1e6);
     std::cout.width(format);
@@ -71,11 +76,15 @@ static void printRecord(size_t size, double avg_time, double avg_bandwidth, doub
     std::cout << (min_time * 1e6);
     std::cout.width(format);
     std::cout << peak_bandwidth;
+    if (status.empty() == false) {
+        std::cout.width(format);
+        std::cout << status;
+    }
     std::cout << std::endl;
 }
 
 static void printCopyBanner(uint32_t src_pool_id, uint32_t src_agent_type, uint32_t dst_pool_id,
-                            uint32_t dst_agent_type, bool unidir) {
+                            uint32_t dst_agent_type, bool unidir, bool validate) {
     std::stringstream src_type;
     std::stringstream dst_type;
     (src_agent_type == 0) ? src_type << "Cpu" : src_type << "Gpu";
@@ -114,6 +123,10 @@ static void printCopyBanner(uint32_t src_pool_id, uint32_t src_agent_type, uint3
     std::cout << "Min Time(us)";
     std::cout.width(format);
     std::cout << "Peak BW(GB/s)";
+    if (validate) {
+        std::cout.width(format);
+        std::cout << ((unidir) ? "Validation" : "Fwd/Rev Valid");
+    }
     std::cout << std::endl;
 }
 
@@ -122,12 +135,12 @@ double RocmBandwidthTest::GetMinTime(std::vector<double>& vec) {
     return vec.at(0);
 }
 
-double RocmBandwidthTest::GetMeanTime(std::vector<double>& vec) {
-    // In validation mode we run only one iteration
-    if (validate_) {
-        return vec.at(0);
-    }
+double RocmBandwidthTest::GetMaxTime(std::vector<double>& vec) {
+    std::sort(vec.begin(), vec.end());
+    return vec.at(vec.size() - 1);
+}
 
+double RocmBandwidthTest::GetMeanTime(std::vector<double>& vec) {
     // Number of elements is ONE plus number of iterations
     std::sort(vec.begin(), vec.end());
     vec.erase(vec.end() - 1);
@@ -141,7 +154,136 @@ double RocmBandwidthTest::GetMeanTime(std::vector<double>& vec) {
     return mean;
 }
 
+double RocmBandwidthTest::GetStdDevTime(std::vector<double>& vec, double mean) {
+    // Sample standard deviation of the times used to compute mean
+    int num = vec.size();
+    if (num < 2) {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (int it = 0; it < num; it++) {
+        sum += (vec[it] - mean) * (vec[it] - mean);
+    }
+    return sqrt(sum / (num - 1));
+}
+
+double RocmBandwidthTest::GetPercentileTime(std::vector<double>& vec, double pct) {
+    std::sort(vec.begin(), vec.end());
+    size_t rank = (size_t)ceil((pct / 100) * vec.size());
+    if (rank > 0) {
+        rank--;
+    }
+    return vec.at(min(rank, vec.size() - 1));
+}
+
 void RocmBandwidthTest::Display() const {
+    // Results have already been emitted into console by result sink
+    if ((result_sink_ != NULL) && (sink_path_ == NULL)) {
+        return;
+    }
+
+    // Results of daemon requests are written to their clients
+    if (daemon_path_ != NULL) {
+        return;
+    }
+
+    if (health_budget_ > 0) {
+        DisplayHealthCheck();
+        return;
+    }
+
+    // Results of scenarios are displayed as they complete
+    if (scenario_list_.size() != 0) {
+        DisplaySessionTime();
+        return;
+    }
+
+    // Size search is reported in sizes reaching shares of peak
+    if (search_list_.size() != 0) {
+        DisplaySizeSearch();
+        return;
+    }
+
+    // Probes timed under load are reported in latency per load level
+    if (load_list_.size() != 0) {
+        DisplayLoadResults();
+        return;
+    }
+
+    // Small copies kept in flight are reported in copies per second
+    if (iops_list_.size() != 0) {
+        DisplayQueueDepthResults();
+        return;
+    }
+
+    DisplayResults();
+    if (agg_bandwidth_list_.size() != 0) {
+        DisplayConcurrentMetrics();
+    }
+    if (stream_list_.size() != 0) {
+        DisplayStreamResults();
+    }
+    if (pace_list_.size() != 0) {
+        DisplayPacingResults();
+    }
+    if (fit_list_.size() != 0) {
+        DisplayLinkFits();
+    }
+    if (grain_compare_) {
+        DisplayGrainComparison();
+    }
+
+    if (round_cnt_ > 1) {
+        DisplayRoundResults();
+    }
+    if (baseline_path_ != NULL) {
+        DisplayComparison();
+    }
+}
+
+void RocmBandwidthTest::DisplayConcurrentMetrics() const {
+    std::cout << std::endl;
+    std::cout << "Aggregate bandwidth (GB/s) and fairness of concurrent copies" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(14) << "Size (MB)";
+    std::cout << std::setw(14) << "Aggregate";
+    std::cout << std::setw(14) << "Fairness" << std::endl;
+    uint32_t size_len = agg_bandwidth_list_.size();
+    for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+        std::cout << std::setw(14) << std::fixed << std::setprecision(3)
+                  << ((double)size_list_[sdx] / (1024 * 1024));
+        std::cout << std::setw(14) << agg_bandwidth_list_[sdx];
+        std::cout << std::setw(14) << fairness_list_[sdx] << std::endl;
+    }
+
+    // Slowdown of every copy against the copy run by itself
+    if (bw_isolated_ == NULL) {
+        std::cout << std::endl;
+        return;
+    }
+    std::cout << std::endl;
+    std::cout << "Slowdown of concurrent copies against isolated copies" << std::endl;
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        std::cout << std::endl;
+        std::cout << "  Src Pool " << trans.copy.src_idx_;
+        std::cout << ((trans.copy.bidir_) ? " <-> " : " -> ");
+        std::cout << "Dst Pool " << trans.copy.dst_idx_ << std::endl;
+        std::cout << std::setw(14) << "Size (MB)";
+        std::cout << std::setw(14) << "Slowdown" << std::endl;
+        uint32_t slow_len = trans.slowdown_.size();
+        for (uint32_t sdx = 0; sdx < slow_len; sdx++) {
+            std::cout << std::setw(14) << std::fixed << std::setprecision(3)
+                      << ((double)size_list_[sdx] / (1024 * 1024));
+            std::cout << std::setw(14) << trans.slowdown_[sdx] << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void RocmBandwidthTest::DisplayResults() const {
     // Iterate through list of transactions and display its timing data
     uint32_t trans_size = trans_list_.size();
     if (trans_size == 0) {
@@ -151,20 +293,15 @@ void RocmBandwidthTest::Display() const {
         return;
     }
 
-    if (validate_) {
-        PrintVersion();
-        DisplayDevInfo();
-        PrintLinkPropsMatrix(LINK_PROP_ACCESS);
-        DisplayValidationMatrix();
-        return;
-    }
-
     if (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) {
         PrintVersion();
         DisplayDevInfo();
         PrintLinkPropsMatrix(LINK_PROP_ACCESS);
         PrintLinkPropsMatrix(LINK_PROP_WEIGHT);
-        DisplayCopyTimeMatrix(true);
+        DisplayCopyTimeMatrices();
+        if (validate_) {
+            DisplayValidationMatrix();
+        }
         return;
     }
 
@@ -175,7 +312,10 @@ void RocmBandwidthTest::Display() const {
             PrintLinkPropsMatrix(LINK_PROP_ACCESS);
             PrintLinkPropsMatrix(LINK_PROP_WEIGHT);
         }
-        DisplayCopyTimeMatrix(true);
+        DisplayCopyTimeMatrices();
+        if (validate_) {
+            DisplayValidationMatrix();
+        }
         return;
     }
 
@@ -212,34 +352,95 @@ void RocmBandwidthTest::DisplayCopyTime(async_trans_t& trans) const {
 
     bool unidir =
         ((trans.req_type_ == REQ_COPY_UNIDIR) || (trans.req_type_ == REQ_CONCURRENT_COPY_UNIDIR));
-    printCopyBanner(src_idx, src_dev_type, dst_idx, dst_dev_type, unidir);
+    printCopyBanner(src_idx, src_dev_type, dst_idx, dst_dev_type, unidir, validate_);
 
     uint32_t size_len = size_list_.size();
     for (uint32_t idx = 0; idx < size_len; idx++) {
+        // Report validation of each direction of the copy
+        std::string status;
+        if (validate_) {
+            status = (trans.fwd_valid_[idx]) ? "PASS" : "FAIL";
+            if (unidir == false) {
+                status += (trans.rev_valid_[idx]) ? "/PASS" : "/FAIL";
+            }
+        }
         printRecord(size_list_[idx], trans.avg_time_[idx], trans.avg_bandwidth_[idx],
-                    trans.min_time_[idx], trans.peak_bandwidth_[idx]);
+                    trans.min_time_[idx], trans.peak_bandwidth_[idx], status);
     }
 }
 
-void RocmBandwidthTest::PopulatePerfMatrix(bool peak, double* perf_matrix) const {
+double RocmBandwidthTest::GetPerfValue(const async_trans_t& trans, uint32_t kind,
+                                       uint32_t size_idx) const {
+    // Deviation of bandwidth is taken relative to average bandwidth
+    // as deviation of copy time is relative to average copy time
+    double cv = 0;
+    if (trans.avg_time_[size_idx] > 0) {
+        cv = trans.std_time_[size_idx] / trans.avg_time_[size_idx];
+    }
+
+    switch (kind) {
+        case PERF_MATRIX_AVG:
+        case PERF_MATRIX_NOISY:
+            return trans.avg_bandwidth_[size_idx];
+        case PERF_MATRIX_STDDEV:
+            return trans.avg_bandwidth_[size_idx] * cv;
+        case PERF_MATRIX_CV:
+            return cv * 100;
+        case PERF_MATRIX_WORST:
+            return trans.min_bandwidth_[size_idx];
+        default:
+            return trans.peak_bandwidth_[size_idx];
+    }
+}
+
+std::string RocmBandwidthTest::GetPerfTitle(uint32_t kind) const {
+    std::stringstream title;
+    title << ((req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) ? "Bidirectional" : "Unidirectional");
+    title << " copy ";
+    switch (kind) {
+        case PERF_MATRIX_AVG:
+            title << "average bandwidth GB/s";
+            break;
+        case PERF_MATRIX_STDDEV:
+            title << "bandwidth standard deviation GB/s";
+            break;
+        case PERF_MATRIX_CV:
+            title << "bandwidth coefficient of variation %";
+            break;
+        case PERF_MATRIX_WORST:
+            title << "worst case bandwidth GB/s";
+            break;
+        case PERF_MATRIX_NOISY:
+            title << "average bandwidth GB/s, * marks variation above " << cv_limit_ << "%";
+            break;
+        default:
+            title << "peak bandwidth GB/s";
+            break;
+    }
+    return title.str();
+}
+
+void RocmBandwidthTest::PopulatePerfMatrix(uint32_t kind, uint32_t size_idx,
+                                           double* perf_matrix) const {
     uint32_t trans_size = trans_list_.size();
     for (uint32_t idx = 0; idx < trans_size; idx++) {
-        async_trans_t trans = trans_list_[idx];
+        const async_trans_t& trans = trans_list_[idx];
         uint32_t src_idx = trans.copy.src_idx_;
         uint32_t dst_idx = trans.copy.dst_idx_;
         uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
         uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
 
-        // For COPY_ALL_UNIDIR and COPY_ALL_BIDIR we use only one copy size
-        double bandwidth = (peak) ? trans.peak_bandwidth_[0] : trans.avg_bandwidth_[0];
-        perf_matrix[(src_dev_idx * agent_index_) + dst_dev_idx] = bandwidth;
+        // For COPY_ALL_UNIDIR and COPY_ALL_BIDIR there is one matrix per copy size
+        double value = GetPerfValue(trans, kind, size_idx);
+        perf_matrix[(src_dev_idx * agent_index_) + dst_dev_idx] = value;
         if (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) {
-            perf_matrix[(dst_dev_idx * agent_index_) + src_dev_idx] = bandwidth;
+            perf_matrix[(dst_dev_idx * agent_index_) + src_dev_idx] = value;
         }
     }
 }
 
-void RocmBandwidthTest::PrintPerfMatrix(bool validate, bool peak, double* perf_matrix) const {
+void RocmBandwidthTest::PrintPerfMatrix(bool validate, uint32_t kind, double* perf_matrix,
+                                        const double* cv_matrix) const {
     uint32_t format = 10;
     std::cout.setf(ios::left);
 
@@ -248,21 +449,7 @@ void RocmBandwidthTest::PrintPerfMatrix(bool validate, bool peak, double* perf_m
     std::cout.width(format);
 
     if (validate == false) {
-        if ((peak) && (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR)) {
-            std::cout << "Unidirectional copy peak bandwidth GB/s";
-        }
-
-        if ((peak == false) && (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR)) {
-            std::cout << "Unidirectional copy average bandwidth GB/s";
-        }
-
-        if ((peak) && (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR)) {
-            std::cout << "Bidirectional copy peak bandwidth GB/s";
-        }
-
-        if ((peak == false) && (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR)) {
-            std::cout << "Bidirectional copy average bandwidth GB/s";
-        }
+        std::cout << GetPerfTitle(kind);
     } else {
         std::cout << "Data Path Validation";
     }
@@ -306,10 +493,15 @@ void RocmBandwidthTest::PrintPerfMatrix(bool validate, bool peak, double* perf_m
                     std::cout << "PASS";
                 }
             } else {
+                uint32_t cell = (idx0 * agent_index_) + idx1;
                 if (value == 0) {
                     std::cout << "N/A";
+                } else if ((cv_matrix != NULL) && (cv_matrix[cell] > cv_limit_)) {
+                    std::stringstream noisy;
+                    noisy << std::fixed << std::setprecision(3) << value << "*";
+                    std::cout << noisy.str();
                 } else {
-                    std::cout << perf_matrix[(idx0 * agent_index_) + idx1];
+                    std::cout << perf_matrix[cell];
                 }
             }
         }
@@ -319,17 +511,271 @@ void RocmBandwidthTest::PrintPerfMatrix(bool validate, bool peak, double* perf_m
     std::cout << std::endl;
 }
 
-void RocmBandwidthTest::DisplayCopyTimeMatrix(bool peak) const {
-    double* perf_matrix = new double[agent_index_ * agent_index_]();
-    PopulatePerfMatrix(peak, perf_matrix);
-    PrintPerfMatrix(false, peak, perf_matrix);
+void RocmBandwidthTest::DisplayCopyTimeMatrices() const {
+    // Peak bandwidth hides links whose copies are slow at times,
+    // so average, spread and worst case bandwidth follow it if
+    // user has requested
+    DisplayCopyTimeMatrix(PERF_MATRIX_PEAK);
+    if (bw_variation_ == NULL) {
+        return;
+    }
+    DisplayCopyTimeMatrix(PERF_MATRIX_AVG);
+    DisplayCopyTimeMatrix(PERF_MATRIX_STDDEV);
+    DisplayCopyTimeMatrix(PERF_MATRIX_CV);
+    DisplayCopyTimeMatrix(PERF_MATRIX_WORST);
+    DisplayCopyTimeMatrix(PERF_MATRIX_NOISY);
+}
+
+void RocmBandwidthTest::DisplayCopyTimeMatrix(uint32_t kind) const {
+    bool multi_pool = HasMultiPoolAgent();
+    uint32_t size_len = size_list_.size();
+    for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+        if (size_len > 1) {
+            std::cout << std::endl;
+            std::cout << "Copy size: " << getSizeString(size_list_[sdx]) << std::endl;
+            std::cout << std::endl;
+        }
+        // Agents with several pools are shown one row and column per pool
+        if (multi_pool) {
+            DisplayPoolPerfMatrix(kind, sdx);
+            continue;
+        }
+
+        double* perf_matrix = new double[agent_index_ * agent_index_]();
+        PopulatePerfMatrix(kind, sdx, perf_matrix);
+
+        // Noisy links are marked by variation of their copy times
+        double* cv_matrix = NULL;
+        if (kind == PERF_MATRIX_NOISY) {
+            cv_matrix = new double[agent_index_ * agent_index_]();
+            PopulatePerfMatrix(PERF_MATRIX_CV, sdx, cv_matrix);
+        }
+        PrintPerfMatrix(false, kind, perf_matrix, cv_matrix);
+        delete[] perf_matrix;
+        delete[] cv_matrix;
+    }
+
+    // Combined table of every pair across sizes
+    if (size_len > 1) {
+        DisplaySizePairTable(kind);
+    }
+}
+
+void RocmBandwidthTest::DisplaySizePairTable(uint32_t kind) const {
+    std::cout << std::endl;
+    std::cout << GetPerfTitle(kind) << " by size" << std::endl;
+    std::cout << std::endl;
+
+    // Pairs are named by device, or by device and pool if
+    // devices have several pools
+    bool multi_pool = HasMultiPoolAgent();
+    uint32_t format = 12;
+    std::cout.setf(ios::left);
+    std::cout.width((multi_pool) ? 20 : format);
+    std::cout << ((multi_pool) ? "Src/Dst (Dev:Pool)" : "Src/Dst");
+    uint32_t size_len = size_list_.size();
+    for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+        std::cout.width(format);
+        std::cout << getSizeString(size_list_[sdx]);
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        const pool_info_t& src_pool = pool_list_[trans.copy.src_idx_];
+        const pool_info_t& dst_pool = pool_list_[trans.copy.dst_idx_];
+        std::stringstream pair;
+        pair << src_pool.agent_index_;
+        if (multi_pool) {
+            pair << ":" << src_pool.index_;
+        }
+        pair << ((trans.copy.bidir_) ? " <-> " : " -> ");
+        pair << dst_pool.agent_index_;
+        if (multi_pool) {
+            pair << ":" << dst_pool.index_;
+        }
+        std::cout.width((multi_pool) ? 20 : format);
+        std::cout << pair.str();
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            std::cout.width(format);
+            double value = GetPerfValue(trans, kind, sdx);
+            double cv = GetPerfValue(trans, PERF_MATRIX_CV, sdx);
+            if ((kind == PERF_MATRIX_NOISY) && (cv > cv_limit_)) {
+                std::stringstream noisy;
+                noisy << std::fixed << std::setprecision(3) << value << "*";
+                std::cout << noisy.str();
+            } else {
+                std::cout << value;
+            }
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+bool RocmBandwidthTest::HasMultiPoolAgent() const {
+    uint32_t agent_size = agent_pool_list_.size();
+    for (uint32_t idx = 0; idx < agent_size; idx++) {
+        if (agent_pool_list_[idx].pool_list.size() > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RocmBandwidthTest::PopulatePoolPerfMatrix(uint32_t kind, uint32_t size_idx,
+                                               double* perf_matrix) const {
+    uint32_t pool_cnt = pool_list_.size();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        uint32_t src_idx = pool_list_[trans.copy.src_idx_].index_;
+        uint32_t dst_idx = pool_list_[trans.copy.dst_idx_].index_;
+
+        // Every pair of pools has a cell of its own
+        double value = GetPerfValue(trans, kind, size_idx);
+        perf_matrix[(src_idx * pool_cnt) + dst_idx] = value;
+        if (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) {
+            perf_matrix[(dst_idx * pool_cnt) + src_idx] = value;
+        }
+    }
+}
+
+void RocmBandwidthTest::DisplayPoolPerfMatrix(uint32_t kind, uint32_t size_idx) const {
+    uint32_t pool_cnt = pool_list_.size();
+    double* perf_matrix = new double[pool_cnt * pool_cnt]();
+    double* cv_matrix = new double[pool_cnt * pool_cnt]();
+    PopulatePoolPerfMatrix(kind, size_idx, perf_matrix);
+    PopulatePoolPerfMatrix(PERF_MATRIX_CV, size_idx, cv_matrix);
+    PrintPoolPerfMatrix(false, kind, perf_matrix, cv_matrix);
     delete[] perf_matrix;
+    delete[] cv_matrix;
+}
+
+void RocmBandwidthTest::PrintPoolPerfMatrix(bool validate, uint32_t kind,
+                                            const double* perf_matrix,
+                                            const double* cv_matrix) const {
+    uint32_t pool_cnt = pool_list_.size();
+    uint32_t format = 10;
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    if (validate == false) {
+        std::cout << GetPerfTitle(kind) << " per pool" << std::endl;
+    } else {
+        std::cout << "Data Path Validation per pool" << std::endl;
+    }
+    std::cout << std::endl;
+
+    // Columns are grouped by device, one column per pool
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "Dev";
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        std::cout.width(12);
+        std::cout << pool_list_[idx].agent_index_;
+    }
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "Pool";
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        std::cout.width(12);
+        std::cout << pool_list_[idx].index_;
+    }
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "Grain";
+    for (uint32_t idx = 0; idx < pool_cnt; idx++) {
+        std::cout.width(12);
+        std::cout << GetPoolGrainTag(idx);
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    for (uint32_t idx0 = 0; idx0 < pool_cnt; idx0++) {
+        std::stringstream pool_id;
+        pool_id << pool_list_[idx0].agent_index_ << ":" << pool_list_[idx0].index_;
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(format);
+        std::cout << pool_id.str();
+        for (uint32_t idx1 = 0; idx1 < pool_cnt; idx1++) {
+            uint32_t cell = (idx0 * pool_cnt) + idx1;
+            double value = perf_matrix[cell];
+            std::cout.width(12);
+            if (value == 0) {
+                std::cout << "N/A";
+            } else if (validate) {
+                std::cout << ((value == VALIDATE_COPY_OP_FAILURE) ? "FAIL" : "PASS");
+            } else if ((kind == PERF_MATRIX_NOISY) && (cv_matrix[cell] > cv_limit_)) {
+                std::stringstream noisy;
+                noisy << std::fixed << std::setprecision(3) << value << "*";
+                std::cout << noisy.str();
+            } else {
+                std::cout << value;
+            }
+        }
+        std::cout << std::endl;
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void RocmBandwidthTest::PopulateValidationMatrix(bool per_pool, double* perf_matrix) const {
+    uint32_t dim = (per_pool) ? pool_list_.size() : agent_index_;
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        uint32_t src_idx = trans.copy.src_idx_;
+        uint32_t dst_idx = trans.copy.dst_idx_;
+        uint32_t src_cell_idx =
+            (per_pool) ? pool_list_[src_idx].index_ : pool_list_[src_idx].agent_index_;
+        uint32_t dst_cell_idx =
+            (per_pool) ? pool_list_[dst_idx].index_ : pool_list_[dst_idx].agent_index_;
+
+        // A cell fails if any size of any transaction between
+        // its two devices or pools failed. Reverse copy of a
+        // bidirectional transaction is reported in the mirror cell
+        bool pass = (std::find(trans.fwd_valid_.begin(), trans.fwd_valid_.end(), false) ==
+                     trans.fwd_valid_.end());
+        double& fwd_cell = perf_matrix[(src_cell_idx * dim) + dst_cell_idx];
+        fwd_cell = ((pass) && (fwd_cell != VALIDATE_COPY_OP_FAILURE)) ? 1 : VALIDATE_COPY_OP_FAILURE;
+        if (trans.copy.bidir_) {
+            pass = (std::find(trans.rev_valid_.begin(), trans.rev_valid_.end(), false) ==
+                    trans.rev_valid_.end());
+            double& rev_cell = perf_matrix[(dst_cell_idx * dim) + src_cell_idx];
+            rev_cell =
+                ((pass) && (rev_cell != VALIDATE_COPY_OP_FAILURE)) ? 1 : VALIDATE_COPY_OP_FAILURE;
+        }
+    }
 }
 
 void RocmBandwidthTest::DisplayValidationMatrix() const {
+    // Agents with several pools are shown one row and column per pool,
+    // as their bandwidth is
+    if (HasMultiPoolAgent()) {
+        uint32_t pool_cnt = pool_list_.size();
+        double* perf_matrix = new double[pool_cnt * pool_cnt]();
+        PopulateValidationMatrix(true, perf_matrix);
+        PrintPoolPerfMatrix(true, PERF_MATRIX_PEAK, perf_matrix, NULL);
+        delete[] perf_matrix;
+        return;
+    }
+
     double* perf_matrix = new double[agent_index_ * agent_index_]();
-    PopulatePerfMatrix(true, perf_matrix);
-    PrintPerfMatrix(true, true, perf_matrix);
+    PopulateValidationMatrix(false, perf_matrix);
+    PrintPerfMatrix(true, PERF_MATRIX_PEAK, perf_matrix, NULL);
     delete[] perf_matrix;
 }
 
@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// Sets up the bandwidth test object to run another scenario of
+// the session, exiting if scenario is invalid for the system
+void RocmBandwidthTest::SetUpScenario(const scenario_t& scenario) {
+    if (PlanScenario(scenario)) {
+        return;
+    }
+    if (scenario.name_.empty()) {
+        PrintHelpScreen();
+    } else {
+        std::cout << "Scenario " << scenario.name_ << " is invalid for this system" << std::endl;
+    }
+    ExitOrRaise(1);
+}
+
+// Builds the list of transactions of a scenario. Roc Runtime,
+// topology and the cache of buffers of the session are retained
+// while the list of transactions and results of previous scenario
+// are reset
+bool RocmBandwidthTest::PlanScenario(const scenario_t& scenario) {
+    req_copy_bidir_ = REQ_INVALID;
+    req_copy_unidir_ = REQ_INVALID;
+    req_copy_all_bidir_ = REQ_INVALID;
+    req_copy_all_unidir_ = REQ_INVALID;
+    req_concurrent_copy_bidir_ = REQ_INVALID;
+    req_concurrent_copy_unidir_ = REQ_INVALID;
+
+    trans_list_.clear();
+    bidir_list_.clear();
+    src_list_.clear();
+    dst_list_.clear();
+    size_list_.clear();
+    compare_list_.clear();
+    if (active_agents_list_ != NULL) {
+        std::memset(active_agents_list_, 0, agent_index_ * sizeof(uint32_t));
+    }
+
+    // Buffers of the source pattern and snapshots are sized by copies
+    // of previous scenario and are allocated again for this one
+    ReleaseInitBuffers();
+
+    // Bind the kind of copy and pools of scenario
+    if (scenario.mode_ == "unidir") {
+        req_copy_unidir_ = REQ_COPY_UNIDIR;
+        src_list_ = scenario.src_list_;
+        dst_list_ = scenario.dst_list_;
+    } else if (scenario.mode_ == "bidir") {
+        req_copy_bidir_ = REQ_COPY_BIDIR;
+        bidir_list_ = scenario.pool_list_;
+    } else if (scenario.mode_ == "all-unidir") {
+        req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
+    } else if (scenario.mode_ == "all-bidir") {
+        req_copy_all_bidir_ = REQ_COPY_ALL_BIDIR;
+    } else if (scenario.mode_ == "concurrent-unidir") {
+        req_concurrent_copy_unidir_ = REQ_CONCURRENT_COPY_UNIDIR;
+        bidir_list_ = scenario.pool_list_;
+    } else {
+        req_concurrent_copy_bidir_ = REQ_CONCURRENT_COPY_BIDIR;
+        bidir_list_ = scenario.pool_list_;
+    }
+    if (scenario.validate_ != SCENARIO_SETTING_INHERIT) {
+        validate_ = (scenario.validate_ != 0);
+    }
+
+    // Determine pools of scenario are present in system before
+    // they are used to index the list of pools
+    bool valid = true;
+    if (req_copy_unidir_ == REQ_COPY_UNIDIR) {
+        valid = (ValidateCopyReq(src_list_) && ValidateCopyReq(dst_list_));
+    } else if (req_copy_bidir_ == REQ_COPY_BIDIR) {
+        valid = ValidateBidirCopyReq();
+    } else if ((req_concurrent_copy_bidir_ == REQ_CONCURRENT_COPY_BIDIR) ||
+               (req_concurrent_copy_unidir_ == REQ_CONCURRENT_COPY_UNIDIR)) {
+        valid = ValidateConcurrentCopyReq();
+        if (pace_list_.size() != 0) {
+            std::cout << "ROCM_BW_RATE can't be combined with concurrent copies" << std::endl;
+            valid = false;
+        }
+    }
+    if (valid == false) {
+        return false;
+    }
+
+    // Build list of transactions as done for user request
+    size_list_ = scenario.size_list_;
+    if ((req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) ||
+        (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR)) {
+        BuildDeviceList();
+    }
+    BuildBufferList();
+    std::sort(size_list_.begin(), size_list_.end());
+    return BuildTransList();
+}
+
+// Initializes Roc Runtime and discovers topology for a session
+// whose scenarios are planned by the caller instead of parsed
+// from command line
+bool RocmBandwidthTest::SetUpSession() {
+    session_start_ = std::chrono::steady_clock::now();
+    err_ = hsa_init();
+    if (err_ != HSA_STATUS_SUCCESS) {
+        return false;
+    }
+    DiscoverTopology();
+    return true;
+}
+
+// @brief: Discard discovered topology so that it can be discovered
+// again, as filters on grain of pools change the list of pools
+void RocmBandwidthTest::ResetTopology() {
+    // Buffers of the cache could belong to pools that are filtered
+    FreeBufferCache();
+
+    // Keep pairs of agents discovered on first use for later runs
+    SaveTopologySnapshot();
+
+    agent_list_.clear();
+    pool_list_.clear();
+    agent_pool_list_.clear();
+    delete[] access_matrix_;
+    delete[] direct_access_matrix_;
+    delete[] link_hops_matrix_;
+    delete[] link_type_matrix_;
+    delete[] link_weight_matrix_;
+    delete[] active_agents_list_;
+    access_matrix_ = NULL;
+    direct_access_matrix_ = NULL;
+    link_hops_matrix_ = NULL;
+    link_type_matrix_ = NULL;
+    link_weight_matrix_ = NULL;
+    active_agents_list_ = NULL;
+    agent_index_ = 0;
+    pool_index_ = 0;
+    cpu_index_ = -1;
+}
+
+// @brief: Save settings of the session, i.e. of the environment
+// variables and defaults, inherited by scenarios
+void RocmBandwidthTest::SaveSessionSettings() {
+    session_iter_cnt_ = num_iteration_;
+    session_validate_ = validate_;
+    session_blocking_ = bw_blocking_run_;
+    session_skip_cpu_fine_grain_ = skip_cpu_fine_grain_;
+    session_skip_gpu_coarse_grain_ = skip_gpu_coarse_grain_;
+}
+
+// @brief: Bind settings of a scenario, inheriting those it does not
+// specify from the session. Topology is discovered again only if
+// filters on grain of pools differ from those of previous scenario
+void RocmBandwidthTest::BindScenarioSettings(const scenario_t& scenario) {
+    char* enable = const_cast<char*>("true");
+    set_num_iteration((scenario.iterations_ == SCENARIO_SETTING_INHERIT) ? session_iter_cnt_
+                                                                          : scenario.iterations_);
+    validate_ = session_validate_;
+    bw_blocking_run_ = (scenario.blocking_ == SCENARIO_SETTING_INHERIT)
+                           ? session_blocking_
+                           : ((scenario.blocking_ != 0) ? enable : NULL);
+
+    char* skip_cpu_fine = (scenario.skip_cpu_fine_grain_ == SCENARIO_SETTING_INHERIT)
+                              ? session_skip_cpu_fine_grain_
+                              : ((scenario.skip_cpu_fine_grain_ != 0) ? enable : NULL);
+    char* skip_gpu_coarse = (scenario.skip_gpu_coarse_grain_ == SCENARIO_SETTING_INHERIT)
+                                ? session_skip_gpu_coarse_grain_
+                                : ((scenario.skip_gpu_coarse_grain_ != 0) ? enable : NULL);
+    bool discover = (agent_index_ == 0) ||
+                    ((skip_cpu_fine_grain_ == NULL) != (skip_cpu_fine == NULL)) ||
+                    ((skip_gpu_coarse_grain_ == NULL) != (skip_gpu_coarse == NULL));
+    skip_cpu_fine_grain_ = skip_cpu_fine;
+    skip_gpu_coarse_grain_ = skip_gpu_coarse;
+    if (discover) {
+        ResetTopology();
+        if (bw_daemon_stub_ != NULL) {
+            BuildStubTopology();
+        } else {
+            DiscoverTopology();
+        }
+    }
+}
+
+// @brief: Run scenarios of scenario file one after another
+void RocmBandwidthTest::RunScenarios() {
+    SaveSessionSettings();
+    scenario_time_list_.clear();
+    uint32_t scenario_cnt = scenario_list_.size();
+    for (uint32_t idx = 0; idx < scenario_cnt; idx++) {
+        const scenario_t& scenario = scenario_list_[idx];
+        std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+        BindScenarioSettings(scenario);
+        SetUpScenario(scenario);
+        RunTransList();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        scenario_time_list_.push_back(elapsed.count());
+
+        // Results of scenario are displayed before the next one runs
+        if ((result_sink_ != NULL) && (sink_path_ == NULL)) {
+            continue;
+        }
+        std::cout << std::endl;
+        std::cout << "Scenario: " << scenario.name_ << std::endl;
+        DisplayResults();
+        if (baseline_path_ != NULL) {
+            DisplayComparison();
+        }
+    }
+}
+
+// @brief: Print time taken by each scenario and the whole session
+void RocmBandwidthTest::DisplaySessionTime() const {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - session_start_;
+    std::cout << std::endl;
+    std::cout << "Session Time (sec)" << std::endl;
+    std::cout.precision(3);
+    std::cout << std::fixed;
+    uint32_t scenario_cnt = scenario_time_list_.size();
+    for (uint32_t idx = 0; idx < scenario_cnt; idx++) {
+        std::cout << "  " << std::setw(24) << std::left << scenario_list_[idx].name_
+                  << std::setw(12) << std::right << scenario_time_list_[idx] << std::endl;
+    }
+    std::cout << "  " << std::setw(24) << std::left << "Total" << std::setw(12) << std::right
+              << elapsed.count() << std::endl;
+    std::cout << std::endl;
+}
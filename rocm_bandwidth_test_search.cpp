@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+size_t RocmBandwidthTest::GetCopyDataSize(const async_trans_t& trans, size_t size) const {
+    // Bidirectional copies and copies within a device move data twice
+    size_t data_size = size;
+    if (trans.copy.bidir_ == true) {
+        data_size += size;
+    }
+    if (trans.copy.src_idx_ == trans.copy.dst_idx_) {
+        data_size += data_size;
+    }
+    return data_size;
+}
+
+double RocmBandwidthTest::MeasureCopyBandwidth(const async_trans_t& trans,
+                                               copy_resources_t& res, size_t size) {
+    // Get the frequency of Gpu Timestamping
+    uint64_t sys_freq = 0;
+    hsa_system_get_info(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+
+    vector<double> cpu_time;
+    vector<double> gpu_time;
+    RunCopyIterations(trans, res, size, GetIterationNum(), cpu_time, gpu_time);
+
+    // Adjust time from nanoseconds or ticks to units of seconds
+    double avg_time = 0;
+    if (print_cpu_time_) {
+        avg_time = GetMeanTime(cpu_time) / 1000 / 1000 / 1000;
+    } else {
+        avg_time = GetMeanTime(gpu_time) / sys_freq;
+    }
+    return (double)GetCopyDataSize(trans, size) / avg_time / 1000 / 1000 / 1000;
+}
+
+void RocmBandwidthTest::RunSizeSearch() {
+    search_list_.clear();
+    uint32_t pct_len = search_pct_list_.size();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        const async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ != REQ_COPY_BIDIR) && (trans.req_type_ != REQ_COPY_UNIDIR)) {
+            continue;
+        }
+
+        // Largest size is bounded by what both pools can allocate for
+        // the buffers of copy, two per pool if copy is bidirectional
+        // or within a pool
+        size_t buf_cnt = ((trans.copy.bidir_) || (trans.copy.src_idx_ == trans.copy.dst_idx_))
+                             ? 2 : 1;
+        size_search_t search;
+        search.trans_idx_ = idx;
+        search.max_size_ = SEARCH_MAX_SIZE;
+        search.max_size_ = min(search.max_size_,
+                               pool_list_[trans.copy.src_idx_].allocable_size_ / buf_cnt);
+        search.max_size_ = min(search.max_size_,
+                               pool_list_[trans.copy.dst_idx_].allocable_size_ / buf_cnt);
+        if (search.max_size_ < SEARCH_MIN_SIZE) {
+            continue;
+        }
+
+        copy_resources_t res;
+        AcquireCopyResources(trans, search.max_size_, res);
+
+        // Coarse sweep over sizes doubling up to the largest size
+        map<size_t, double> bw_map;
+        vector<size_t> sweep_list;
+        for (size_t size = SEARCH_MIN_SIZE; size < search.max_size_; size *= 2) {
+            sweep_list.push_back(size);
+        }
+        sweep_list.push_back(search.max_size_);
+        search.peak_bandwidth_ = 0;
+        for (uint32_t sdx = 0; sdx < sweep_list.size(); sdx++) {
+            double bandwidth = MeasureCopyBandwidth(trans, res, sweep_list[sdx]);
+            bw_map[sweep_list[sdx]] = bandwidth;
+            search.peak_bandwidth_ = max(search.peak_bandwidth_, bandwidth);
+        }
+
+        // Bisect between the last size of sweep below the share of
+        // peak and the first size reaching it, down to a byte
+        for (uint32_t pdx = 0; pdx < pct_len; pdx++) {
+            double target = search.peak_bandwidth_ * search_pct_list_[pdx] / 100;
+            uint32_t hi_idx = 0;
+            while (bw_map[sweep_list[hi_idx]] < target) {
+                hi_idx++;
+            }
+            size_t lo = (hi_idx == 0) ? 0 : sweep_list[hi_idx - 1];
+            size_t hi = sweep_list[hi_idx];
+            while ((hi - lo) > 1) {
+                size_t mid = lo + ((hi - lo) / 2);
+                if (bw_map.find(mid) == bw_map.end()) {
+                    bw_map[mid] = MeasureCopyBandwidth(trans, res, mid);
+                }
+                if (bw_map[mid] >= target) {
+                    hi = mid;
+                } else {
+                    lo = mid;
+                }
+            }
+            search.knee_size_.push_back(hi);
+            search.knee_bandwidth_.push_back(bw_map[hi]);
+        }
+
+        ReleaseCopyResources(res);
+        search_list_.push_back(search);
+    }
+}
+
+void RocmBandwidthTest::DisplaySizeSearch() const {
+    std::cout << std::endl;
+    std::cout << "Smallest size (B) reaching shares of peak bandwidth (GB/s)" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(22) << "Src Pool -> Dst Pool";
+    std::cout << std::setw(14) << "Max Size (B)";
+    std::cout << std::setw(12) << "Peak";
+    uint32_t pct_len = search_pct_list_.size();
+    for (uint32_t pdx = 0; pdx < pct_len; pdx++) {
+        std::cout << std::setw(14) << (std::to_string(search_pct_list_[pdx]) + "%");
+        std::cout << std::setw(12) << "GB/s";
+    }
+    std::cout << std::endl;
+
+    uint32_t search_size = search_list_.size();
+    for (uint32_t idx = 0; idx < search_size; idx++) {
+        const size_search_t& search = search_list_[idx];
+        const async_trans_t& trans = trans_list_[search.trans_idx_];
+        std::string pair = std::to_string(trans.copy.src_idx_) +
+                           ((trans.copy.bidir_) ? " <-> " : " -> ") +
+                           std::to_string(trans.copy.dst_idx_);
+        std::cout << std::setw(22) << pair;
+        std::cout << std::setw(14) << search.max_size_;
+        std::cout << std::setw(12) << std::fixed << std::setprecision(3)
+                  << search.peak_bandwidth_;
+        for (uint32_t pdx = 0; pdx < pct_len; pdx++) {
+            std::cout << std::setw(14) << search.knee_size_[pdx];
+            std::cout << std::setw(12) << search.knee_bandwidth_[pdx];
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
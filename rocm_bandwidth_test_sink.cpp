@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <iostream>
+#include <sstream>
+
+// @brief: Open the sink to emit results into. Sink writes into
+// the file specified by user or else into the console
+void RocmBandwidthTest::OpenResultSink() {
+    if ((sink_format_ == SINK_FORMAT_INVALID) && (sink_path_ == NULL)) {
+        return;
+    }
+
+    // Results written to a file default to JSON format
+    if (sink_format_ == SINK_FORMAT_INVALID) {
+        sink_format_ = SINK_FORMAT_JSON;
+    }
+
+    if (sink_path_ == NULL) {
+        result_sink_ = CreateResultSink(sink_format_, std::cout);
+        return;
+    }
+
+    sink_file_.open(sink_path_, std::ios::out | std::ios::trunc);
+    if (sink_file_.is_open() == false) {
+        std::cout << "Unable to open file to write results: " << sink_path_ << std::endl;
+        ExitOrRaise(1);
+    }
+    result_sink_ = CreateResultSink(sink_format_, sink_file_);
+}
+
+void RocmBandwidthTest::BuildResultEndpoint(uint32_t pool_idx,
+                                            result_endpoint_t& endpoint) const {
+    const pool_info_t& pool = pool_list_[pool_idx];
+    const agent_info_t& agent = agent_list_[pool.agent_index_];
+    endpoint.pool_idx_ = pool_idx;
+    endpoint.dev_idx_ = pool.agent_index_;
+    endpoint.dev_type_ = (agent.device_type_ == HSA_DEVICE_TYPE_CPU) ? "CPU" : "GPU";
+    endpoint.name_ = agent.name_;
+    endpoint.bdf_ = agent.bdf_id_;
+    endpoint.uuid_ = agent.uuid_;
+    endpoint.fine_grained_ = pool.is_fine_grained_;
+    endpoint.pool_ord_ = 0;
+    for (uint32_t idx = 0; idx < pool_idx; idx++) {
+        if (pool_list_[idx].agent_index_ == pool.agent_index_) {
+            endpoint.pool_ord_++;
+        }
+    }
+
+    // Gpu is identified by its UUID or else its BDF. Cpu agents
+    // have neither and are identified by name and ordinal
+    if (agent.device_type_ == HSA_DEVICE_TYPE_GPU) {
+        endpoint.id_ = (endpoint.uuid_.empty()) ? endpoint.bdf_ : endpoint.uuid_;
+        return;
+    }
+    uint32_t ordinal = 0;
+    for (uint32_t idx = 0; idx < pool.agent_index_; idx++) {
+        if (agent_list_[idx].device_type_ == HSA_DEVICE_TYPE_CPU) {
+            ordinal++;
+        }
+    }
+    std::stringstream stream;
+    stream << "CPU" << ordinal << ":" << endpoint.name_;
+    endpoint.id_ = stream.str();
+}
+
+// @brief: Collect records of every copy transaction of last run
+void RocmBandwidthTest::GetResults(vector<result_record_t>& record_list) const {
+    record_list.clear();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        BuildResultRecords(trans_list_[idx], record_list);
+    }
+}
+
+// @brief: Build one record per copy size of a transaction
+void RocmBandwidthTest::BuildResultRecords(const async_trans_t& trans,
+                                           vector<result_record_t>& record_list) const {
+    result_record_t record;
+    switch (trans.req_type_) {
+        case REQ_COPY_BIDIR:
+            record.mode_ = "bidir";
+            break;
+        case REQ_COPY_UNIDIR:
+            record.mode_ = "unidir";
+            break;
+        case REQ_COPY_ALL_BIDIR:
+            record.mode_ = "all-bidir";
+            break;
+        case REQ_COPY_ALL_UNIDIR:
+            record.mode_ = "all-unidir";
+            break;
+        case REQ_CONCURRENT_COPY_BIDIR:
+            record.mode_ = "concurrent-bidir";
+            break;
+        case REQ_CONCURRENT_COPY_UNIDIR:
+            record.mode_ = "concurrent-unidir";
+            break;
+        default:
+            return;
+    }
+
+    BuildResultEndpoint(trans.copy.src_idx_, record.src_);
+    BuildResultEndpoint(trans.copy.dst_idx_, record.dst_);
+
+    // Capture properties of link binding the two devices
+    uint32_t src_dev_idx = record.src_.dev_idx_;
+    uint32_t dst_dev_idx = record.dst_.dev_idx_;
+    uint32_t link_type = GetLinkProp(LINK_PROP_TYPE, src_dev_idx, dst_dev_idx);
+    if (link_type == LINK_TYPE_XGMI) {
+        record.link_type_ = "XGMI";
+    } else if (link_type == LINK_TYPE_PCIE) {
+        record.link_type_ = "PCIe";
+    } else {
+        record.link_type_ = "N/A";
+    }
+    record.link_hops_ = GetLinkProp(LINK_PROP_HOPS, src_dev_idx, dst_dev_idx);
+    record.link_weight_ = GetLinkProp(LINK_PROP_WEIGHT, src_dev_idx, dst_dev_idx);
+
+    // Mean copy time excludes the slowest of the iterations
+    record.sample_cnt_ = num_iteration_;
+
+    uint32_t size_len = trans.avg_time_.size();
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        record.size_ = size_list_[idx];
+        record.avg_time_ = trans.avg_time_[idx];
+        record.min_time_ = trans.min_time_[idx];
+        record.std_time_ = trans.std_time_[idx];
+        record.avg_bandwidth_ = trans.avg_bandwidth_[idx];
+        record.peak_bandwidth_ = trans.peak_bandwidth_[idx];
+        record.validation_.clear();
+        if (validate_) {
+            record.validation_ = (trans.fwd_valid_[idx]) ? "PASS" : "FAIL";
+            if (trans.copy.bidir_) {
+                record.validation_ += (trans.rev_valid_[idx]) ? "/PASS" : "/FAIL";
+            }
+        }
+        record_list.push_back(record);
+    }
+}
+
+// @brief: Emit one record per copy size of a transaction
+void RocmBandwidthTest::EmitResults(const async_trans_t& trans) {
+    if (result_sink_ == NULL) {
+        return;
+    }
+
+    vector<result_record_t> record_list;
+    BuildResultRecords(trans, record_list);
+    for (uint32_t idx = 0; idx < record_list.size(); idx++) {
+        result_sink_->Record(record_list[idx]);
+    }
+
+    // Streaming sinks write out results of each transaction as
+    // it completes, others hold them until the run is complete
+    result_sink_->Flush();
+}
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+void RocmBandwidthTest::RunStreamScaling() {
+    stream_list_.clear();
+    uint32_t trans_size = trans_list_.size();
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+        async_trans_t& trans = trans_list_[idx];
+        if ((trans.req_type_ != REQ_COPY_BIDIR) && (trans.req_type_ != REQ_COPY_UNIDIR)) {
+            continue;
+        }
+
+        // Every stream is a copy of the transaction with its own buffers
+        for (uint32_t cnt = 1; cnt <= stream_cnt_; cnt++) {
+            vector<async_trans_t> streams(cnt, trans);
+            RunConcurrentCopyBenchmark(trans.copy.bidir_, streams);
+            ComputeCopyTime(streams);
+            ComputeConcurrentMetrics(streams);
+
+            // Throughput of each stream is averaged over the streams
+            stream_result_t result;
+            result.trans_idx_ = idx;
+            result.stream_cnt_ = cnt;
+            result.total_bandwidth_ = agg_bandwidth_list_;
+            result.fairness_ = fairness_list_;
+            uint32_t size_len = agg_bandwidth_list_.size();
+            for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+                double sum_bandwidth = 0;
+                for (uint32_t sidx = 0; sidx < cnt; sidx++) {
+                    sum_bandwidth += streams[sidx].avg_bandwidth_[sdx];
+                }
+                result.stream_bandwidth_.push_back(sum_bandwidth / cnt);
+            }
+            stream_list_.push_back(result);
+
+            // Results of a single stream are the results of transaction
+            if (cnt == 1) {
+                trans_list_[idx] = streams[0];
+                EmitResults(trans_list_[idx]);
+            }
+        }
+    }
+
+    // Metrics of streams are not of a concurrent copy request
+    concurrent_window_time_.clear();
+    agg_bandwidth_list_.clear();
+    fairness_list_.clear();
+}
+
+void RocmBandwidthTest::DisplayStreamResults() const {
+    std::cout << std::endl;
+    std::cout << "Bandwidth (GB/s) of copies run as concurrent streams" << std::endl;
+
+    uint32_t prev_idx = trans_list_.size();
+    uint32_t result_size = stream_list_.size();
+    for (uint32_t idx = 0; idx < result_size; idx++) {
+        const stream_result_t& result = stream_list_[idx];
+        const async_trans_t& trans = trans_list_[result.trans_idx_];
+        if (result.trans_idx_ != prev_idx) {
+            prev_idx = result.trans_idx_;
+            std::cout << std::endl;
+            std::cout << "  Src Pool " << trans.copy.src_idx_;
+            std::cout << ((trans.copy.bidir_) ? " <-> " : " -> ");
+            std::cout << "Dst Pool " << trans.copy.dst_idx_ << std::endl;
+            std::cout << std::setw(14) << "Size (MB)";
+            std::cout << std::setw(10) << "Streams";
+            std::cout << std::setw(14) << "Total";
+            std::cout << std::setw(14) << "Per Stream";
+            std::cout << std::setw(14) << "Fairness" << std::endl;
+        }
+        uint32_t size_len = result.total_bandwidth_.size();
+        for (uint32_t sdx = 0; sdx < size_len; sdx++) {
+            std::cout << std::setw(14) << std::fixed << std::setprecision(3)
+                      << ((double)size_list_[sdx] / (1024 * 1024));
+            std::cout << std::setw(10) << result.stream_cnt_;
+            std::cout << std::setw(14) << result.total_bandwidth_[sdx];
+            std::cout << std::setw(14) << result.stream_bandwidth_[sdx];
+            std::cout << std::setw(14) << result.fairness_[sdx] << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
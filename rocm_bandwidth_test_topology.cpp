@@ -43,6 +43,7 @@
 #include "common.hpp"
 #include "rocm_bandwidth_test.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <iomanip>
 #include <sstream>
@@ -57,7 +58,9 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
     // Query pools' segment, report only pools from global segment
     hsa_amd_segment_t segment;
     status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_SEGMENT, &segment);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
     if (HSA_AMD_SEGMENT_GLOBAL != segment) {
         return HSA_STATUS_SUCCESS;
     }
@@ -67,7 +70,9 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
     bool alloc = false;
     status =
         hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_ALLOWED, &alloc);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
     if (alloc != true) {
         return HSA_STATUS_SUCCESS;
     }
@@ -75,25 +80,33 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
     // Query the max allocatable size
     size_t max_size = 0;
     status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_SIZE, &max_size);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
 
     // Determine if the pools is accessible to all agents
     bool access_to_all = false;
     status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_ACCESSIBLE_BY_ALL,
                                           &access_to_all);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
 
     // Determine type of access to owner agent
     hsa_amd_memory_pool_access_t owner_access;
     hsa_agent_t agent = asyncDrvr->agent_list_.back().agent_;
     status = hsa_amd_agent_memory_pool_get_info(agent, pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS,
                                                 &owner_access);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
 
     // Determine if the pool is fine-grained or coarse-grained
     uint32_t flag = 0;
     status = hsa_amd_memory_pool_get_info(pool, HSA_AMD_MEMORY_POOL_INFO_GLOBAL_FLAGS, &flag);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
     bool is_kernarg = (HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_KERNARG_INIT & flag);
     bool is_fine_grained = (HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_FINE_GRAINED & flag);
 
@@ -104,9 +117,11 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
 
     // Consult user request and add either fine-grained or
     // coarse-grained memory pools if agent is CPU. Default
-    // is to skip coarse-grained memory pools
+    // is to skip coarse-grained memory pools. Pools of every
+    // grain are added if user is comparing grains
     agent_info_t& agent_info = asyncDrvr->agent_list_.back();
-    if (agent_info.device_type_ == HSA_DEVICE_TYPE_CPU) {
+    if ((asyncDrvr->grain_compare_ == false) &&
+        (agent_info.device_type_ == HSA_DEVICE_TYPE_CPU)) {
         if (asyncDrvr->skip_cpu_fine_grain_ != NULL) {
             if (is_fine_grained == true) {
                 return HSA_STATUS_SUCCESS;
@@ -124,7 +139,8 @@ hsa_status_t MemPoolInfo(hsa_amd_memory_pool_t pool, void* data) {
     // Consult user request and add either fine-grained or
     // coarse-grained memory pools if agent is GPU. Default
     // is to skip fine-grained memory pools
-    if (agent_info.device_type_ == HSA_DEVICE_TYPE_GPU) {
+    if ((asyncDrvr->grain_compare_ == false) &&
+        (agent_info.device_type_ == HSA_DEVICE_TYPE_GPU)) {
         if (asyncDrvr->skip_gpu_coarse_grain_ != NULL) {
             if (is_fine_grained == false) {
                 return HSA_STATUS_SUCCESS;
@@ -168,12 +184,16 @@ hsa_status_t AgentInfo(hsa_agent_t agent, void* data) {
     char agent_name[64];
     hsa_status_t status;
     status = hsa_agent_get_info(agent, HSA_AGENT_INFO_NAME, agent_name);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
 
     // Get device type
     hsa_device_type_t device_type;
     status = hsa_agent_get_info(agent, HSA_AGENT_INFO_DEVICE, &device_type);
-    ErrorCheck(status);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
 
     // Capture the handle of Cpu agent
     if (device_type == HSA_DEVICE_TYPE_CPU) {
@@ -206,65 +226,160 @@ hsa_status_t AgentInfo(hsa_agent_t agent, void* data) {
     asyncDrvr->agent_pool_list_.push_back(node);
 
     status = hsa_amd_agent_iterate_memory_pools(agent, MemPoolInfo, asyncDrvr);
+    if (status != HSA_STATUS_SUCCESS) {
+        return status;
+    }
     asyncDrvr->agent_index_++;
 
     return HSA_STATUS_SUCCESS;
 }
 
-void RocmBandwidthTest::PopulateAccessMatrix() {
-    // Allocate memory to hold access lists
-    access_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-    direct_access_matrix_ = new uint32_t[agent_index_ * agent_index_]();
+// @brief: Allocate matrices of access and link properties with
+// every entry marked as not yet discovered
+void RocmBandwidthTest::AllocateLinkMatrices() {
+    uint32_t count = agent_index_ * agent_index_;
+    access_matrix_ = new uint32_t[count];
+    direct_access_matrix_ = new uint32_t[count];
+    link_hops_matrix_ = new uint32_t[count];
+    link_type_matrix_ = new uint32_t[count];
+    link_weight_matrix_ = new uint32_t[count];
+
+    // Copied as std::fill binds a reference to the value, which needs
+    // a definition of the class constant that is not provided
+    uint32_t unknown = LINK_PROP_UNKNOWN;
+    std::fill(access_matrix_, access_matrix_ + count, unknown);
+    std::fill(direct_access_matrix_, direct_access_matrix_ + count, unknown);
+    std::fill(link_hops_matrix_, link_hops_matrix_ + count, unknown);
+    std::fill(link_type_matrix_, link_type_matrix_ + count, unknown);
+    std::fill(link_weight_matrix_, link_weight_matrix_ + count, unknown);
+}
+
+// @brief: Determine if Src agent can access memory of Dst agent.
+// Access is determined using the last pool of either agent
+void RocmBandwidthTest::BindAccess(uint32_t src_dev_idx, uint32_t dst_dev_idx) const {
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+    uint32_t idx = (src_dev_idx * agent_index_) + dst_dev_idx;
+    topology_dirty_ = true;
+
+    // Agents without pools have no path between them
+    const vector<pool_info_t>& src_pool_list = agent_pool_list_[src_dev_idx].pool_list;
+    const vector<pool_info_t>& dst_pool_list = agent_pool_list_[dst_dev_idx].pool_list;
+    if ((src_pool_list.size() == 0) || (dst_pool_list.size() == 0)) {
+        access_matrix_[idx] = 0;
+        direct_access_matrix_[idx] = 0;
+        return;
+    }
+
+    // Get handle of Src and Dst agents and their pools
+    hsa_agent_t src_agent = agent_list_[src_dev_idx].agent_;
+    hsa_amd_memory_pool_t src_pool = src_pool_list.back().pool_;
+    hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
+    hsa_agent_t dst_agent = agent_list_[dst_dev_idx].agent_;
+    hsa_amd_memory_pool_t dst_pool = dst_pool_list.back().pool_;
+    hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
 
+    // Determine if src agent has access to dst pool
     hsa_status_t status;
-    uint32_t size = pool_list_.size();
-    for (uint32_t src_idx = 0; src_idx < size; src_idx++) {
-        // Get handle of Src agent of the pool
-        uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
-        hsa_agent_t src_agent = pool_list_[src_idx].owner_agent_;
-        hsa_amd_memory_pool_t src_pool = pool_list_[src_idx].pool_;
-        hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
-
-        for (uint32_t dst_idx = 0; dst_idx < size; dst_idx++) {
-            // Get handle of Dst pool
-            uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
-            hsa_agent_t dst_agent = pool_list_[dst_idx].owner_agent_;
-            hsa_amd_memory_pool_t dst_pool = pool_list_[dst_idx].pool_;
-            hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
-
-            // Determine if src agent has access to dst pool
-            hsa_amd_memory_pool_access_t access;
-            status = hsa_amd_agent_memory_pool_get_info(
-                src_agent, dst_pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
-            ErrorCheck(status);
-
-            // Record if Src device can access or not
-            uint32_t path;
-            path = (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) ? 0 : 1;
-            direct_access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx] = path;
-
-            if ((src_dev_type == HSA_DEVICE_TYPE_CPU) && (dst_dev_type == HSA_DEVICE_TYPE_GPU) &&
-                (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED)) {
-                status = hsa_amd_agent_memory_pool_get_info(
-                    dst_agent, src_pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
-                ErrorCheck(status);
-            }
+    hsa_amd_memory_pool_access_t access;
+    status = hsa_amd_agent_memory_pool_get_info(src_agent, dst_pool,
+                                                HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
+    ErrorCheck(status);
+
+    // Record if Src device can access or not
+    uint32_t path;
+    path = (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) ? 0 : 1;
+    direct_access_matrix_[idx] = path;
+
+    if ((src_dev_type == HSA_DEVICE_TYPE_CPU) && (dst_dev_type == HSA_DEVICE_TYPE_GPU) &&
+        (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED)) {
+        status = hsa_amd_agent_memory_pool_get_info(dst_agent, src_pool,
+                                                    HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
+        ErrorCheck(status);
+    }
 
-            // Access between the two agents is Non-Existent
-            path = (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) ? 0 : 1;
-            access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx] = path;
+    // Access between the two agents is Non-Existent
+    path = (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) ? 0 : 1;
+    access_matrix_[idx] = path;
+
+    setup_time_.access_time_ += std::chrono::steady_clock::now() - start;
+    setup_time_.access_cnt_++;
+}
+
+void RocmBandwidthTest::PopulateAccessMatrix() {
+    for (uint32_t src_dev_idx = 0; src_dev_idx < agent_index_; src_dev_idx++) {
+        for (uint32_t dst_dev_idx = 0; dst_dev_idx < agent_index_; dst_dev_idx++) {
+            GetAccess(src_dev_idx, dst_dev_idx);
         }
     }
 }
 
+// @brief: Return access of Src agent to memory of Dst agent,
+// discovering it on first use. Topology restored without Roc
+// Runtime reports pairs its snapshot did not discover as unknown
+uint32_t RocmBandwidthTest::GetAccess(uint32_t src_dev_idx, uint32_t dst_dev_idx) const {
+    uint32_t idx = (src_dev_idx * agent_index_) + dst_dev_idx;
+    if ((access_matrix_[idx] == LINK_PROP_UNKNOWN) && (topology_offline_ == false)) {
+        BindAccess(src_dev_idx, dst_dev_idx);
+    }
+    return access_matrix_[idx];
+}
+
+// @brief: Return a property of link binding Src and Dst agents,
+// discovering it on first use. Access is reported as direct access
+uint32_t RocmBandwidthTest::GetLinkProp(uint32_t key, uint32_t src_dev_idx,
+                                        uint32_t dst_dev_idx) const {
+    uint32_t idx = (src_dev_idx * agent_index_) + dst_dev_idx;
+    if (key == LINK_PROP_ACCESS) {
+        if ((direct_access_matrix_[idx] == LINK_PROP_UNKNOWN) && (topology_offline_ == false)) {
+            BindAccess(src_dev_idx, dst_dev_idx);
+        }
+        return direct_access_matrix_[idx];
+    }
+
+    if (link_type_matrix_[idx] == LINK_PROP_UNKNOWN) {
+        if (topology_offline_) {
+            return LINK_PROP_UNKNOWN;
+        }
+        BindLinkProps(src_dev_idx, dst_dev_idx);
+    }
+    switch (key) {
+        case LINK_PROP_HOPS:
+            return link_hops_matrix_[idx];
+        case LINK_PROP_TYPE:
+            return link_type_matrix_[idx];
+        case LINK_PROP_WEIGHT:
+            return link_weight_matrix_[idx];
+    }
+    return LINK_PROP_UNKNOWN;
+}
+
+// @brief: Discover agents and pools of the system. Access and link
+// properties of every pair of agents are discovered only if user
+// request involves all of them. Otherwise they are discovered as
+// and when they are used, and saved into the snapshot once the
+// topology is discarded
 void RocmBandwidthTest::DiscoverTopology() {
     // Populate the lists of agents and pools
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
     err_ = hsa_iterate_agents(AgentInfo, this);
+    ErrorCheck(err_);
+    setup_time_.discovery_time_ = std::chrono::steady_clock::now() - start;
+
+    // Reuse matrices of a snapshot taken on the same hardware. Pairs
+    // it did not discover are discovered as if there was no snapshot
+    if (LoadTopologySnapshot(false) == false) {
+        AllocateLinkMatrices();
+    }
+    bool eager = ((req_topology_ == REQ_TOPOLOGY) || (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) ||
+                  (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR));
+    if (eager == false) {
+        return;
+    }
 
     // Populate the access, link type and weight matrices
-    // Access matrix must be populated first
     PopulateAccessMatrix();
     DiscoverLinkProps();
+    SaveTopologySnapshot();
 }
 
 uint32_t GetLinkType(hsa_device_type_t src_dev_type, hsa_device_type_t dst_dev_type,
@@ -301,7 +416,18 @@ uint32_t GetLinkWeight(hsa_amd_memory_pool_link_info_t* link_info, uint32_t hops
     return weight;
 }
 
-void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2) {
+void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2) const {
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+    topology_dirty_ = true;
+
+    // Agent has no link to itself
+    if (idx1 == idx2) {
+        link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0;
+        link_weight_matrix_[(idx1 * agent_index_) + idx2] = 0;
+        link_type_matrix_[(idx1 * agent_index_) + idx2] = LINK_TYPE_SELF;
+        return;
+    }
+
     // Agent has no pools so no need to look for numa distance
     if (agent_pool_list_[idx2].pool_list.size() == 0) {
         link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0xFFFFFFFF;
@@ -312,13 +438,15 @@ void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2) {
 
     uint32_t hops = 0;
     hsa_agent_t agent1 = agent_list_[idx1].agent_;
-    hsa_amd_memory_pool_t& pool = agent_pool_list_[idx2].pool_list[0].pool_;
-    err_ = hsa_amd_agent_memory_pool_get_info(agent1, pool,
-                                              HSA_AMD_AGENT_MEMORY_POOL_INFO_NUM_LINK_HOPS, &hops);
+    const hsa_amd_memory_pool_t& pool = agent_pool_list_[idx2].pool_list[0].pool_;
+    hsa_amd_agent_memory_pool_get_info(agent1, pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_NUM_LINK_HOPS,
+                                       &hops);
     if (hops < 1) {
         link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0xFFFFFFFF;
         link_weight_matrix_[(idx1 * agent_index_) + idx2] = 0xFFFFFFFF;
         link_type_matrix_[(idx1 * agent_index_) + idx2] = LINK_TYPE_NO_PATH;
+        setup_time_.link_time_ += std::chrono::steady_clock::now() - start;
+        setup_time_.link_cnt_++;
         return;
     }
 
@@ -326,9 +454,8 @@ void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2) {
     uint32_t link_info_sz = hops * sizeof(hsa_amd_memory_pool_link_info_t);
     link_info = (hsa_amd_memory_pool_link_info_t*)malloc(link_info_sz);
     std::memset(link_info, 0, (hops * sizeof(hsa_amd_memory_pool_link_info_t)));
-    err_ = hsa_amd_agent_memory_pool_get_info(agent1, pool,
-                                              HSA_AMD_AGENT_MEMORY_POOL_INFO_LINK_INFO, link_info);
-
+    hsa_amd_agent_memory_pool_get_info(agent1, pool, HSA_AMD_AGENT_MEMORY_POOL_INFO_LINK_INFO,
+                                       link_info);
 
     link_hops_matrix_[(idx1 * agent_index_) + idx2] = hops;
     link_weight_matrix_[(idx1 * agent_index_) + idx2] = GetLinkWeight(link_info, hops);
@@ -341,26 +468,17 @@ void RocmBandwidthTest::BindLinkProps(uint32_t idx1, uint32_t idx2) {
         GetLinkType(src_dev_type, dst_dev_type, link_info, hops);
     // Free the allocated link block
     free(link_info);
+
+    setup_time_.link_time_ += std::chrono::steady_clock::now() - start;
+    setup_time_.link_cnt_++;
 }
 
 void RocmBandwidthTest::DiscoverLinkProps() {
-    // Allocate space if it is first time
-    if (link_weight_matrix_ == NULL) {
-        link_type_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-        link_hops_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-        link_weight_matrix_ = new uint32_t[agent_index_ * agent_index_]();
-    }
-
-    agent_info_t agent_info;
     for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
         for (uint32_t idx2 = 0; idx2 < agent_index_; idx2++) {
-            if (idx1 == idx2) {
-                link_hops_matrix_[(idx1 * agent_index_) + idx2] = 0;
-                link_weight_matrix_[(idx1 * agent_index_) + idx2] = 0;
-                link_type_matrix_[(idx1 * agent_index_) + idx2] = LINK_TYPE_SELF;
-                continue;
+            if (link_type_matrix_[(idx1 * agent_index_) + idx2] == LINK_PROP_UNKNOWN) {
+                BindLinkProps(idx1, idx2);
             }
-            BindLinkProps(idx1, idx2);
         }
     }
 }
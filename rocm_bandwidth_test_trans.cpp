@@ -166,7 +166,7 @@ bool RocmBandwidthTest::BuildCopyTrans(uint32_t req_type, vector<size_t>& src_li
             }
 
             // Determine if accessibility to dst pool for src agent is not denied
-            uint32_t path_exists = access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx];
+            uint32_t path_exists = GetAccess(src_dev_idx, dst_dev_idx);
             if (path_exists == 0) {
                 if ((req_type == REQ_COPY_ALL_BIDIR) || (req_type == REQ_COPY_ALL_UNIDIR)) {
                     continue;
@@ -180,7 +180,7 @@ bool RocmBandwidthTest::BuildCopyTrans(uint32_t req_type, vector<size_t>& src_li
             // Both paths are valid when one of the devices is a CPU. This is
             // not true when both of the devices are GPU's.
             if ((req_type == REQ_COPY_ALL_BIDIR) || (req_type == REQ_COPY_ALL_UNIDIR)) {
-                path_exists = access_matrix_[(dst_dev_idx * agent_index_) + src_dev_idx];
+                path_exists = GetAccess(dst_dev_idx, src_dev_idx);
                 if (path_exists == 0) {
                     continue;
                 }
@@ -254,7 +254,7 @@ bool RocmBandwidthTest::BuildConcurrentCopyTrans(uint32_t req_type, vector<size_
         }
 
         // Determine if accessibility to dst pool for src agent is not denied
-        uint32_t path_exists = access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx];
+        uint32_t path_exists = GetAccess(src_dev_idx, dst_dev_idx);
         if (path_exists == 0) {
             PrintCopyAccessError(src_idx, dst_idx);
             return false;
@@ -264,7 +264,7 @@ bool RocmBandwidthTest::BuildConcurrentCopyTrans(uint32_t req_type, vector<size_
         // Both paths are valid when one of the devices is a CPU. This is
         // not true when both of the devices are GPU's.
         if (req_type == REQ_CONCURRENT_COPY_BIDIR) {
-            path_exists = access_matrix_[(dst_dev_idx * agent_index_) + src_dev_idx];
+            path_exists = GetAccess(dst_dev_idx, src_dev_idx);
             if (path_exists == 0) {
                 PrintCopyAccessError(dst_idx, src_idx);
                 return false;
@@ -364,17 +364,81 @@ void RocmBandwidthTest::ComputeCopyTime(std::vector<async_trans_t>& trans_list)
     }
 }
 
-void RocmBandwidthTest::ComputeCopyTime(async_trans_t& trans) {
+void RocmBandwidthTest::ComputeConcurrentMetrics(std::vector<async_trans_t>& trans_list) {
     // Get the frequency of Gpu Timestamping
     uint64_t sys_freq = 0;
     hsa_system_get_info(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
 
+    agg_bandwidth_list_.clear();
+    fairness_list_.clear();
+    uint32_t trans_cnt = trans_list.size();
+    uint32_t size_len = concurrent_window_time_.size();
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+        size_t total_size = 0;
+        double sum_bandwidth = 0;
+        double sum_sq_bandwidth = 0;
+        for (uint32_t tidx = 0; tidx < trans_cnt; tidx++) {
+            async_trans_t& trans = trans_list[tidx];
+
+            // Adjust size of data involved in copy
+            size_t data_size = size_list_[idx];
+            if (trans.copy.bidir_ == true) {
+                data_size += size_list_[idx];
+            }
+            if (trans.copy.src_idx_ == trans.copy.dst_idx_) {
+                data_size += data_size;
+            }
+            total_size += data_size;
+
+            double bandwidth = trans.avg_bandwidth_[idx];
+            sum_bandwidth += bandwidth;
+            sum_sq_bandwidth += bandwidth * bandwidth;
+
+            // Slowdown of copy against the copy run by itself
+            if (idx == 0) {
+                trans.slowdown_.clear();
+            }
+            double slowdown = 0;
+            if (idx < trans.isolated_time_.size() && trans.isolated_time_[idx] > 0) {
+                slowdown = trans.gpu_avg_time_[idx] / trans.isolated_time_[idx];
+            }
+            trans.slowdown_.push_back(slowdown);
+        }
+
+        // Aggregate bandwidth over the window from the earliest start
+        // to the latest end of the copies
+        double window_time = concurrent_window_time_[idx] / sys_freq;
+        agg_bandwidth_list_.push_back((double)total_size / window_time / 1000 / 1000 / 1000);
+
+        // Jain's fairness index of bandwidth of the copies
+        double fairness = 0;
+        if (sum_sq_bandwidth > 0) {
+            fairness = (sum_bandwidth * sum_bandwidth) / (trans_cnt * sum_sq_bandwidth);
+        }
+        fairness_list_.push_back(fairness);
+    }
+}
+
+void RocmBandwidthTest::ComputeCopyTime(async_trans_t& trans) {
+    // Get the frequency of Gpu Timestamping, not used if copies
+    // are timed by the Cpu
+    uint64_t sys_freq = 0;
+    if (print_cpu_time_ == false) {
+        hsa_system_get_info(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+    }
+
     double avg_time = 0;
     double min_time = 0;
+    double std_time = 0;
+    double max_time = 0;
     size_t data_size = 0;
     double avg_bandwidth = 0;
     double peak_bandwidth = 0;
+    double min_bandwidth = 0;
+    double time_unit = 1;
     uint32_t size_len = size_list_.size();
+    uint32_t round_cnt = trans.round_time_.size() / size_len;
+    trans.round_bandwidth_.clear();
     for (uint32_t idx = 0; idx < size_len; idx++) {
         // Adjust size of data involved in copy
         data_size = size_list_[idx];
@@ -392,44 +456,48 @@ void RocmBandwidthTest::ComputeCopyTime(async_trans_t& trans) {
         if ((print_cpu_time_) || (trans.copy.uses_gpu_ != true)) {
             avg_time = trans.cpu_avg_time_[idx];
             min_time = trans.cpu_min_time_[idx];
+            std_time = trans.cpu_std_time_[idx];
+            max_time = trans.cpu_max_time_[idx];
+            time_unit = 1000.0 * 1000 * 1000;
             avg_time = avg_time / 1000 / 1000 / 1000;
             min_time = min_time / 1000 / 1000 / 1000;
+            std_time = std_time / 1000 / 1000 / 1000;
+            max_time = max_time / 1000 / 1000 / 1000;
         } else {
             avg_time = trans.gpu_avg_time_[idx];
             min_time = trans.gpu_min_time_[idx];
+            std_time = trans.gpu_std_time_[idx];
+            max_time = trans.gpu_max_time_[idx];
         }
 
-        // Determine if there was a validation failure
-        // @note: Value is set to VALIDATE_COPY_OP_FAILURE
-        // if copy transaction wa validated and it failed
-        hsa_status_t verify_status = HSA_STATUS_ERROR;
-        if ((avg_time != VALIDATE_COPY_OP_FAILURE) && (min_time != VALIDATE_COPY_OP_FAILURE)) {
-            verify_status = HSA_STATUS_SUCCESS;
-        }
-
-        // Adjust Gpu time if there is no validation error
-        if ((trans.copy.uses_gpu_) && (print_cpu_time_ == false) &&
-            (verify_status == HSA_STATUS_SUCCESS)) {
+        // Adjust Gpu time from ticks to units of seconds
+        if ((trans.copy.uses_gpu_) && (print_cpu_time_ == false)) {
+            time_unit = sys_freq;
             avg_time = avg_time / sys_freq;
             min_time = min_time / sys_freq;
+            std_time = std_time / sys_freq;
+            max_time = max_time / sys_freq;
         }
 
         // Compute bandwidth - divide bandwidth with
         // 10^9 not 1024^3 to get size in GigaBytes
-        // @note: For validation failures bandwidth
-        // is encoded by VALIDATE_COPY_OP_FAILURE
-        if (verify_status != HSA_STATUS_SUCCESS) {
-            avg_bandwidth = VALIDATE_COPY_OP_FAILURE;
-            peak_bandwidth = VALIDATE_COPY_OP_FAILURE;
-        } else {
-            avg_bandwidth = (double)data_size / avg_time / 1000 / 1000 / 1000;
-            peak_bandwidth = (double)data_size / min_time / 1000 / 1000 / 1000;
-        }
+        avg_bandwidth = (double)data_size / avg_time / 1000 / 1000 / 1000;
+        peak_bandwidth = (double)data_size / min_time / 1000 / 1000 / 1000;
+        min_bandwidth = (double)data_size / max_time / 1000 / 1000 / 1000;
 
         // Update computed bandwidth for the transaction
         trans.min_time_.push_back(min_time);
         trans.avg_time_.push_back(avg_time);
+        trans.std_time_.push_back(std_time);
         trans.avg_bandwidth_.push_back(avg_bandwidth);
         trans.peak_bandwidth_.push_back(peak_bandwidth);
+        trans.max_time_.push_back(max_time);
+        trans.min_bandwidth_.push_back(min_bandwidth);
+
+        // Bandwidth of every round if copies were run in rounds
+        for (uint32_t rdx = 0; rdx < round_cnt; rdx++) {
+            double round_time = trans.round_time_[(idx * round_cnt) + rdx] / time_unit;
+            trans.round_bandwidth_.push_back((double)data_size / round_time / 1000 / 1000 / 1000);
+        }
     }
 }
@@ -134,6 +134,10 @@ bool RocmBandwidthTest::ValidateCopyReq(vector<size_t>& in_list) {
 bool RocmBandwidthTest::ValidateBidirCopyReq() { return ValidateCopyReq(bidir_list_); }
 
 bool RocmBandwidthTest::ValidateUnidirCopyReq() {
+    // Determine pools of link loaded by background copies are present
+    if ((load_pair_.size() != 0) && (PoolIsPresent(load_pair_) == false)) {
+        return false;
+    }
     return ((ValidateCopyReq(src_list_)) && (ValidateCopyReq(dst_list_)));
 }
 
@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "scenario.hpp"
+#include "size_spec.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// @brief: Remove leading and trailing white space
+static std::string Trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t\r");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t\r");
+    return value.substr(start, end - start + 1);
+}
+
+// @brief: Parse a list of decimal values separated by comma
+static bool ParseList(const std::string& value, vector<size_t>& value_list) {
+    std::stringstream stream(value);
+    std::string token;
+    value_list.clear();
+    while (std::getline(stream, token, ',')) {
+        token = Trim(token);
+        char* end = NULL;
+        unsigned long num = strtoul(token.c_str(), &end, 10);
+        if ((token.empty()) || (*end != '\0')) {
+            return false;
+        }
+        value_list.push_back(num);
+    }
+    return (value_list.size() != 0);
+}
+
+static bool ParseBool(const std::string& value, int32_t& flag) {
+    if ((value == "true") || (value == "yes") || (value == "1")) {
+        flag = 1;
+        return true;
+    }
+    if ((value == "false") || (value == "no") || (value == "0")) {
+        flag = 0;
+        return true;
+    }
+    return false;
+}
+
+// @brief: Determine a scenario has the settings its mode requires
+bool ValidateScenario(const scenario_t& scenario, std::string& error) {
+    const std::string& mode = scenario.mode_;
+    if (mode.empty()) {
+        error = "scenario " + scenario.name_ + " has no mode";
+        return false;
+    }
+    if (mode == "unidir") {
+        if ((scenario.src_list_.size() == 0) || (scenario.dst_list_.size() == 0)) {
+            error = "scenario " + scenario.name_ + " needs src and dst pools";
+            return false;
+        }
+        return true;
+    }
+    if (mode == "bidir") {
+        if (scenario.pool_list_.size() == 0) {
+            error = "scenario " + scenario.name_ + " needs pools";
+            return false;
+        }
+        return true;
+    }
+    if ((mode == "concurrent-unidir") || (mode == "concurrent-bidir")) {
+        if ((scenario.pool_list_.size() == 0) || ((scenario.pool_list_.size() % 2) != 0)) {
+            error = "scenario " + scenario.name_ + " needs pairs of pools";
+            return false;
+        }
+        return true;
+    }
+    if ((mode == "all-unidir") || (mode == "all-bidir")) {
+        return true;
+    }
+    error = "scenario " + scenario.name_ + " has unknown mode " + mode;
+    return false;
+}
+
+// @brief: Bind a setting of scenario given by key and its value
+static bool SetScenarioSetting(scenario_t& scenario, const std::string& key,
+                               const std::string& value, std::string& error) {
+    bool status = true;
+    if (key == "name") {
+        scenario.name_ = value;
+    } else if (key == "mode") {
+        scenario.mode_ = value;
+    } else if (key == "src") {
+        status = ParseList(value, scenario.src_list_);
+    } else if (key == "dst") {
+        status = ParseList(value, scenario.dst_list_);
+    } else if (key == "pools") {
+        status = ParseList(value, scenario.pool_list_);
+    } else if (key == "sizes") {
+        std::string spec_error;
+        status = ParseSizeSpec(value, 1024 * 1024, scenario.size_list_, spec_error);
+    } else if (key == "iterations") {
+        char* end = NULL;
+        scenario.iterations_ = strtol(value.c_str(), &end, 10);
+        status = ((value.empty() == false) && (*end == '\0') && (scenario.iterations_ > 0));
+    } else if (key == "validate") {
+        status = ParseBool(value, scenario.validate_);
+    } else if (key == "blocking") {
+        status = ParseBool(value, scenario.blocking_);
+    } else if (key == "skip_cpu_fine_grained") {
+        status = ParseBool(value, scenario.skip_cpu_fine_grain_);
+    } else if (key == "skip_gpu_coarse_grained") {
+        status = ParseBool(value, scenario.skip_gpu_coarse_grain_);
+    } else {
+        error = "unknown key " + key;
+        return false;
+    }
+    if (status == false) {
+        error = "invalid value for " + key;
+        return false;
+    }
+    return true;
+}
+
+bool ParseScenarioFields(const map<std::string, std::string>& fields, scenario_t& scenario,
+                         std::string& error) {
+    map<std::string, std::string>::const_iterator iter;
+    for (iter = fields.begin(); iter != fields.end(); iter++) {
+        if (iter->first == "request") {
+            continue;
+        }
+        if (SetScenarioSetting(scenario, iter->first, Trim(iter->second), error) == false) {
+            return false;
+        }
+    }
+    return ValidateScenario(scenario, error);
+}
+
+bool ParseScenarioFile(const char* path, vector<scenario_t>& scenario_list, std::string& error) {
+    std::ifstream file(path);
+    if (file.is_open() == false) {
+        error = std::string("unable to open ") + path;
+        return false;
+    }
+
+    std::string line;
+    uint32_t line_num = 0;
+    while (std::getline(file, line)) {
+        line_num++;
+        line = Trim(line);
+        if ((line.empty()) || (line[0] == '#') || (line[0] == ';')) {
+            continue;
+        }
+
+        std::stringstream where;
+        where << "line " << line_num << ": ";
+
+        // Beginning of a new scenario
+        if (line[0] == '[') {
+            if (line[line.size() - 1] != ']') {
+                error = where.str() + "malformed scenario name";
+                return false;
+            }
+            if ((scenario_list.size() != 0) &&
+                (ValidateScenario(scenario_list.back(), error) == false)) {
+                return false;
+            }
+            scenario_t scenario;
+            scenario.name_ = Trim(line.substr(1, line.size() - 2));
+            scenario_list.push_back(scenario);
+            continue;
+        }
+
+        size_t pos = line.find('=');
+        if ((pos == std::string::npos) || (scenario_list.size() == 0)) {
+            error = where.str() + "expected key = value within a scenario";
+            return false;
+        }
+
+        std::string key = Trim(line.substr(0, pos));
+        std::string value = Trim(line.substr(pos + 1));
+        if (SetScenarioSetting(scenario_list.back(), key, value, error) == false) {
+            error = where.str() + error;
+            return false;
+        }
+    }
+
+    if (scenario_list.size() == 0) {
+        error = "no scenarios found";
+        return false;
+    }
+    return ValidateScenario(scenario_list.back(), error);
+}
@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_SCENARIO_HPP
+#define ROC_BANDWIDTH_TEST_SCENARIO_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Value of a scenario setting that is not specified in scenario
+// file, in which case setting of the session is used
+#define SCENARIO_SETTING_INHERIT (-1)
+
+// Describes one benchmark of a session run from a scenario file
+typedef struct scenario {
+        scenario() {
+            iterations_ = SCENARIO_SETTING_INHERIT;
+            validate_ = SCENARIO_SETTING_INHERIT;
+            blocking_ = SCENARIO_SETTING_INHERIT;
+            skip_cpu_fine_grain_ = SCENARIO_SETTING_INHERIT;
+            skip_gpu_coarse_grain_ = SCENARIO_SETTING_INHERIT;
+        }
+
+        // Name of scenario and kind of copy, named as in results
+        // e.g. unidir, bidir, all-unidir, concurrent-bidir
+        std::string name_;
+        std::string mode_;
+
+        // Pools used as source and destination of unidirectional
+        // copies, or pools of bidirectional and concurrent copies
+        vector<size_t> src_list_;
+        vector<size_t> dst_list_;
+        vector<size_t> pool_list_;
+
+        // Sizes of copies in bytes, default sizes if empty
+        vector<size_t> size_list_;
+
+        // Number of iterations, validation, blocking wait and filters
+        // on grain of pools, each a boolean unless inherited
+        int32_t iterations_;
+        int32_t validate_;
+        int32_t blocking_;
+        int32_t skip_cpu_fine_grain_;
+        int32_t skip_gpu_coarse_grain_;
+
+} scenario_t;
+
+// @brief: Parse a scenario file into list of scenarios. File lists
+// named scenarios, each a section of key value pairs:
+//
+//    # Comment
+//    [h2d]
+//    mode = unidir
+//    src = 0
+//    dst = 1,2
+//    sizes = 1,64
+//    iterations = 20
+//
+// Returns false with a description of the error if file is invalid
+bool ParseScenarioFile(const char* path, vector<scenario_t>& scenario_list, std::string& error);
+
+// @brief: Build a scenario from its settings given as fields keyed
+// by the names of scenario file, as found in a request of a client.
+// Returns false with a description of the error if it is invalid
+bool ParseScenarioFields(const map<std::string, std::string>& fields, scenario_t& scenario,
+                         std::string& error);
+
+// @brief: Determine a scenario has the settings its mode requires.
+// Returns false with a description of the error if it is invalid
+bool ValidateScenario(const scenario_t& scenario, std::string& error);
+
+#endif    // ROC_BANDWIDTH_TEST_SCENARIO_HPP
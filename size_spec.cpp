@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "size_spec.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+// @brief: Parse a size made of a decimal value and an optional unit
+static bool ParseSize(const std::string& value, uint64_t default_unit, uint64_t& size) {
+    size_t pos = 0;
+    while ((pos < value.size()) && (isdigit(value[pos]))) {
+        pos++;
+    }
+    if (pos == 0) {
+        return false;
+    }
+
+    uint64_t unit = default_unit;
+    std::string suffix = value.substr(pos);
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::toupper);
+    if (suffix == "B") {
+        unit = 1;
+    } else if ((suffix == "K") || (suffix == "KB")) {
+        unit = 1024;
+    } else if ((suffix == "M") || (suffix == "MB")) {
+        unit = 1024 * 1024;
+    } else if ((suffix == "G") || (suffix == "GB")) {
+        unit = 1024 * 1024 * 1024;
+    } else if (suffix.empty() == false) {
+        return false;
+    }
+
+    errno = 0;
+    uint64_t num = strtoull(value.substr(0, pos).c_str(), NULL, 10);
+    if ((errno != 0) || (num == 0) || (num > (std::numeric_limits<uint64_t>::max() / unit))) {
+        return false;
+    }
+    size = num * unit;
+    return true;
+}
+
+// @brief: Expand a range of sizes with a geometric or linear step
+static bool ParseRange(const std::string& item, uint64_t default_unit, vector<size_t>& size_list,
+                       std::string& error) {
+    std::stringstream stream(item);
+    std::string first, last, step;
+    std::getline(stream, first, ':');
+    std::getline(stream, last, ':');
+    std::getline(stream, step);
+
+    uint64_t start = 0;
+    uint64_t end = 0;
+    if ((ParseSize(first, default_unit, start) == false) ||
+        (ParseSize(last, default_unit, end) == false) || (start > end)) {
+        error = "invalid range of sizes " + item;
+        return false;
+    }
+
+    // Sizes double if range has no step
+    bool geometric = true;
+    uint64_t factor = 2;
+    uint64_t increment = 0;
+    if (step.empty() == false) {
+        char kind = step[0];
+        std::string value = step.substr(1);
+        char* stop = NULL;
+        if ((kind == 'x') || (kind == 'X')) {
+            factor = strtoull(value.c_str(), &stop, 10);
+            if ((value.empty()) || (*stop != '\0') || (factor < 2)) {
+                error = "invalid factor of range " + item;
+                return false;
+            }
+        } else if ((kind == '+') && (ParseSize(value, default_unit, increment))) {
+            geometric = false;
+        } else {
+            error = "invalid step of range " + item;
+            return false;
+        }
+    }
+
+    uint64_t size = start;
+    while (size <= end) {
+        if (size_list.size() >= SIZE_SPEC_MAX_CNT) {
+            error = "too many sizes in range " + item;
+            return false;
+        }
+        size_list.push_back(size);
+
+        // Stop before the next size would overflow
+        uint64_t left = std::numeric_limits<uint64_t>::max();
+        if ((geometric) && (size > (left / factor))) {
+            break;
+        }
+        if ((geometric == false) && (size > (left - increment))) {
+            break;
+        }
+        size = (geometric) ? (size * factor) : (size + increment);
+    }
+    return true;
+}
+
+// @brief: Parse a size spec into a sorted list of distinct sizes
+bool ParseSizeSpec(const std::string& spec, uint64_t default_unit, vector<size_t>& size_list,
+                   std::string& error) {
+    size_list.clear();
+    std::stringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.find(':') != std::string::npos) {
+            if (ParseRange(item, default_unit, size_list, error) == false) {
+                return false;
+            }
+            continue;
+        }
+
+        uint64_t size = 0;
+        if (ParseSize(item, default_unit, size) == false) {
+            error = "invalid size " + item;
+            return false;
+        }
+        size_list.push_back(size);
+    }
+
+    if (size_list.size() == 0) {
+        error = "no sizes given";
+        return false;
+    }
+    if (size_list.size() > SIZE_SPEC_MAX_CNT) {
+        error = "too many sizes";
+        return false;
+    }
+    std::sort(size_list.begin(), size_list.end());
+    size_list.erase(std::unique(size_list.begin(), size_list.end()), size_list.end());
+    return true;
+}
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_SIZE_SPEC_HPP
+#define ROC_BANDWIDTH_TEST_SIZE_SPEC_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Largest number of sizes a size spec may expand into
+#define SIZE_SPEC_MAX_CNT (4096)
+
+// @brief: Parse a size spec into a sorted list of distinct sizes in
+// bytes. Spec is a list of items separated by comma, each a size or
+// a range of sizes:
+//
+//    64          size in default unit
+//    4K, 2M, 1G  size with unit suffix B, K, M or G, in powers of 1024
+//    4K:1G:x2    sizes from 4K up to 1G, each twice the previous one
+//    1M:64M:+1M  sizes from 1M up to 64M, in steps of 1M
+//
+// Returns false with a description of the error if spec is invalid
+bool ParseSizeSpec(const std::string& spec, uint64_t default_unit, vector<size_t>& size_list,
+                   std::string& error);
+
+#endif    // ROC_BANDWIDTH_TEST_SIZE_SPEC_HPP
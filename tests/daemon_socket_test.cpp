@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Drives the socket of a daemon serving requests with the stub, so
+// that requests are planned and their results built by the engine
+// on systems without devices. Path of the test program built with
+// the stub is given as the only argument. Returns zero if every
+// request is answered as expected
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Number of attempts, one every 100 ms, to connect to the daemon
+static const uint32_t CONNECT_ATTEMPT_CNT = 100;
+
+// @brief: Connect to the socket of daemon once it is listening
+static int ConnectDaemon(const std::string& path) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    for (uint32_t idx = 0; idx < CONNECT_ATTEMPT_CNT; idx++) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(100 * 1000);
+    }
+    return -1;
+}
+
+// @brief: Send a request and collect lines of its response up to
+// and including the status line
+static bool SendRequest(int fd, const std::string& request, std::string& pending,
+                        std::vector<std::string>& line_list) {
+    std::string line = request + "\n";
+    if (send(fd, line.data(), line.size(), MSG_NOSIGNAL) != (ssize_t)line.size()) {
+        return false;
+    }
+
+    line_list.clear();
+    char buffer[4096];
+    while (true) {
+        size_t pos;
+        while ((pos = pending.find('\n')) != std::string::npos) {
+            line_list.push_back(pending.substr(0, pos));
+            pending.erase(0, pos + 1);
+            if (line_list.back().find("\"status\"") != std::string::npos) {
+                return true;
+            }
+        }
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count <= 0) {
+            return false;
+        }
+        pending.append(buffer, count);
+    }
+}
+
+// @brief: Count lines of a response that hold the given text
+static uint32_t CountLines(const std::vector<std::string>& line_list, const std::string& text) {
+    uint32_t count = 0;
+    for (uint32_t idx = 0; idx < line_list.size(); idx++) {
+        if (line_list[idx].find(text) != std::string::npos) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// @brief: Report a failed check, returning false
+static bool Fail(const std::string& check, const std::vector<std::string>& line_list) {
+    std::cout << "FAILED: " << check << std::endl;
+    for (uint32_t idx = 0; idx < line_list.size(); idx++) {
+        std::cout << "    " << line_list[idx] << std::endl;
+    }
+    return false;
+}
+
+// @brief: Run requests over a connection to the daemon and check
+// their responses
+static bool RunRequests(int fd) {
+    std::string pending;
+    std::vector<std::string> line_list;
+
+    if ((SendRequest(fd, "{\"request\": \"ping\"}", pending, line_list) == false) ||
+        (CountLines(line_list, "\"status\": \"ok\"") != 1)) {
+        return Fail("ping", line_list);
+    }
+
+    // One record per pair of pools and size, validated copies pass
+    std::string request = "{\"mode\": \"unidir\", \"src\": [0], \"dst\": [1, 2], "
+                          "\"sizes\": [1, 4], \"validate\": true}";
+    if ((SendRequest(fd, request, pending, line_list) == false) ||
+        (CountLines(line_list, "\"records\": 4}") != 1) ||
+        (CountLines(line_list, "\"mode\": \"unidir\"") != 4) ||
+        (CountLines(line_list, "\"size\": 4194304,") != 2) ||
+        (CountLines(line_list, "\"validation\": \"PASS\"") != 4)) {
+        return Fail("unidir request", line_list);
+    }
+
+    // Links between Gpu devices of the stub are reported as XGMI
+    request = "{\"mode\": \"bidir\", \"pools\": [1, 2], \"sizes\": [64]}";
+    if ((SendRequest(fd, request, pending, line_list) == false) ||
+        (CountLines(line_list, "\"records\": 1}") != 1) ||
+        (CountLines(line_list, "\"link_type\": \"XGMI\"") != 1)) {
+        return Fail("bidir request", line_list);
+    }
+
+    // Pools that are not present are rejected by the engine
+    request = "{\"mode\": \"unidir\", \"src\": [0], \"dst\": [7]}";
+    if ((SendRequest(fd, request, pending, line_list) == false) ||
+        (CountLines(line_list, "\"status\": \"error\"") != 1)) {
+        return Fail("request of pool not present", line_list);
+    }
+
+    if ((SendRequest(fd, "{\"request\": \"shutdown\"}", pending, line_list) == false) ||
+        (CountLines(line_list, "\"status\": \"ok\"") != 1)) {
+        return Fail("shutdown", line_list);
+    }
+    return true;
+}
+
+// @brief: Start another daemon on the socket of a live daemon and
+// check that it refuses to take the socket over
+static bool CheckSecondDaemon(const char* program, const std::string& sock_path) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cout << "FAILED: unable to start second daemon" << std::endl;
+        return false;
+    }
+    if (pid == 0) {
+        execl(program, program, "-D", sock_path.c_str(), (char*)NULL);
+        _exit(127);
+    }
+
+    int exit_status = 0;
+    waitpid(pid, &exit_status, 0);
+    if ((WIFEXITED(exit_status) == false) || (WEXITSTATUS(exit_status) != 1)) {
+        std::cout << "FAILED: second daemon exited with status " << exit_status << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cout << "Usage: " << argv[0] << " <path of rocm-bandwidth-test>" << std::endl;
+        return 2;
+    }
+
+    std::stringstream path;
+    path << "/tmp/rbt_daemon_test_" << getpid() << ".sock";
+    std::string sock_path = path.str();
+
+    setenv("ROCM_BW_DAEMON_STUB", "1", 1);
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cout << "Unable to start daemon" << std::endl;
+        return 1;
+    }
+    if (pid == 0) {
+        execl(argv[1], argv[1], "-D", sock_path.c_str(), (char*)NULL);
+        _exit(127);
+    }
+
+    bool status = false;
+    int fd = ConnectDaemon(sock_path);
+    if (fd < 0) {
+        std::cout << "FAILED: unable to connect to " << sock_path << std::endl;
+        kill(pid, SIGTERM);
+    } else {
+        status = CheckSecondDaemon(argv[1], sock_path) && RunRequests(fd);
+        close(fd);
+        if (status == false) {
+            kill(pid, SIGTERM);
+        }
+    }
+
+    // Daemon exits cleanly once asked to shut down
+    int exit_status = 0;
+    waitpid(pid, &exit_status, 0);
+    if ((status) && ((WIFEXITED(exit_status) == false) || (WEXITSTATUS(exit_status) != 0))) {
+        std::cout << "FAILED: daemon exited with status " << exit_status << std::endl;
+        status = false;
+    }
+    unlink(sock_path.c_str());
+    return (status) ? 0 : 1;
+}
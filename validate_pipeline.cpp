@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "validate_pipeline.hpp"
+
+#include "checksum.hpp"
+
+ValidatePipeline::ValidatePipeline() {
+    pending_ = 0;
+    in_place_pending_ = 0;
+    fill_value_ = 0;
+    stop_ = false;
+}
+
+ValidatePipeline::~ValidatePipeline() { Stop(); }
+
+void ValidatePipeline::Start(uint32_t worker_cnt, const vector<void*>& buffer_list,
+                             uint8_t fill_value) {
+    free_list_ = buffer_list;
+    fill_value_ = fill_value;
+    stop_ = false;
+    for (uint32_t idx = 0; idx < worker_cnt; idx++) {
+        worker_list_.push_back(std::thread(&ValidatePipeline::WorkerLoop, this));
+    }
+}
+
+void ValidatePipeline::Stop() {
+    if (IsStarted() == false) {
+        return;
+    }
+
+    Drain();
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        stop_ = true;
+    }
+    job_cv_.notify_all();
+
+    for (uint32_t idx = 0; idx < worker_list_.size(); idx++) {
+        worker_list_[idx].join();
+    }
+    worker_list_.clear();
+    free_list_.clear();
+}
+
+void* ValidatePipeline::AcquireBuffer() {
+    std::unique_lock<std::mutex> guard(lock_);
+    done_cv_.wait(guard, [this] { return (free_list_.size() != 0); });
+    void* buffer = free_list_.back();
+    free_list_.pop_back();
+    return buffer;
+}
+
+void ValidatePipeline::Submit(const validate_job_t& job) {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        job_list_.push_back(job);
+        pending_++;
+        if (job.in_place_) {
+            in_place_pending_++;
+        }
+    }
+    job_cv_.notify_one();
+}
+
+void ValidatePipeline::Drain() {
+    std::unique_lock<std::mutex> guard(lock_);
+    done_cv_.wait(guard, [this] { return (pending_ == 0); });
+}
+
+void ValidatePipeline::WaitInPlace() {
+    std::unique_lock<std::mutex> guard(lock_);
+    done_cv_.wait(guard, [this] { return (in_place_pending_ == 0); });
+}
+
+bool ValidatePipeline::GetResult(uint32_t flow, size_t& offset) {
+    std::lock_guard<std::mutex> guard(lock_);
+    offset = 0;
+    map<uint32_t, validate_result_t>::iterator it = result_map_.find(flow);
+    if (it == result_map_.end()) {
+        return true;
+    }
+    offset = it->second.offset_;
+    return it->second.pass_;
+}
+
+void ValidatePipeline::ResetResults() {
+    std::lock_guard<std::mutex> guard(lock_);
+    result_map_.clear();
+}
+
+void ValidatePipeline::WorkerLoop() {
+    while (true) {
+        validate_job_t job;
+        {
+            std::unique_lock<std::mutex> guard(lock_);
+            job_cv_.wait(guard, [this] { return ((stop_) || (job_list_.size() != 0)); });
+            if (job_list_.size() == 0) {
+                return;
+            }
+            job = job_list_.front();
+            job_list_.pop_front();
+        }
+
+        // Snapshot copies are issued asynchronously by the producer
+        if (job.wait_ready_) {
+            while (hsa_signal_wait_acquire(job.ready_, HSA_SIGNAL_CONDITION_LT, 1,
+                                           uint64_t(-1), HSA_WAIT_STATE_BLOCKED))
+                ;
+        }
+
+        // Hash the snapshot outside of the lock and only fall
+        // back to a byte compare for chunks that differ
+        size_t offset = 0;
+        vector<uint64_t> hash_list;
+        ComputeChunkHashes(job.snapshot_, job.size_, job.stride_, hash_list);
+        bool pass = FindFirstMismatch(job.expected_, job.snapshot_, job.size_, job.stride_,
+                                      *job.expected_hash_, hash_list, offset);
+        FillSampledPages(job.snapshot_, job.size_, job.stride_, fill_value_);
+
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            validate_result_t& result = result_map_[job.flow_];
+            // Keep the lowest offset so the report does not depend
+            // on which worker finished first
+            if ((pass == false) && ((result.pass_) || (offset < result.offset_))) {
+                result.pass_ = false;
+                result.offset_ = offset;
+            }
+            if (job.in_place_) {
+                in_place_pending_--;
+            } else {
+                free_list_.push_back(job.snapshot_);
+            }
+            pending_--;
+        }
+        done_cv_.notify_all();
+    }
+}
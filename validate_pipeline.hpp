@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+//
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+//
+// Developed by:
+//
+//                 AMD Research and AMD HSA Software Development
+//
+//                 Advanced Micro Devices, Inc.
+//
+//                 www.amd.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_VALIDATE_PIPELINE_HPP
+#define ROC_BANDWIDTH_TEST_VALIDATE_PIPELINE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hsa/hsa.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Describes one snapshot of a destination buffer to be verified
+typedef struct validate_job {
+        // Source pattern the snapshot is expected to match and
+        // its precomputed chunk hashes
+        const void* expected_;
+        const vector<uint64_t>* expected_hash_;
+
+        // Host buffer holding the snapshot, returned to the
+        // free list once it has been verified. In place jobs
+        // verify a host visible destination buffer directly
+        void* snapshot_;
+        bool in_place_;
+
+        // Signal of the copy filling the snapshot, waited on
+        // before verification when wait_ready_ is set
+        hsa_signal_t ready_;
+        bool wait_ready_;
+
+        // Number of bytes to verify and page sampling stride
+        size_t size_;
+        uint32_t stride_;
+
+        // Identifies the copy flow the snapshot belongs to
+        uint32_t flow_;
+
+} validate_job_t;
+
+// Outcome of verifying all snapshots of a flow
+typedef struct validate_result {
+        validate_result() {
+            pass_ = true;
+            offset_ = 0;
+        }
+
+        bool pass_;
+
+        // Lowest offset of a mismatching byte over all failures
+        size_t offset_;
+
+} validate_result_t;
+
+// Verifies snapshots of destination buffers on worker threads while
+// the benchmark keeps issuing copies. Snapshots live in a fixed set
+// of host buffers that rotate between the producer and the workers
+class ValidatePipeline {
+    public:
+        ValidatePipeline();
+        ~ValidatePipeline();
+
+        // @brief: Launch worker threads that verify snapshots held
+        // in the given list of host buffers. Pages of a snapshot that
+        // were verified are refilled with fill_value before the buffer
+        // is reused, so a copy that fails to land is always detected
+        void Start(uint32_t worker_cnt, const vector<void*>& buffer_list, uint8_t fill_value);
+
+        // @brief: Stop worker threads once pending jobs complete
+        void Stop();
+
+        // @brief: Determine if worker threads are running
+        bool IsStarted() const { return (worker_list_.size() != 0); }
+
+        // @brief: Block until a snapshot buffer is free and return it
+        void* AcquireBuffer();
+
+        // @brief: Queue a snapshot for verification
+        void Submit(const validate_job_t& job);
+
+        // @brief: Block until every queued snapshot is verified
+        void Drain();
+
+        // @brief: Block until every queued in place job is verified,
+        // after which its destination buffer may be written again
+        void WaitInPlace();
+
+        // @brief: Return verification status of a flow since results
+        // were last reset. Flows without snapshots report a pass
+        bool GetResult(uint32_t flow, size_t& offset);
+
+        // @brief: Forget results of all flows
+        void ResetResults();
+
+    private:
+        // @brief: Body of worker threads
+        void WorkerLoop();
+
+        std::mutex lock_;
+
+        // Signalled when a job is queued or workers must stop
+        std::condition_variable job_cv_;
+
+        // Signalled when a job completes and its buffer is free
+        std::condition_variable done_cv_;
+
+        std::deque<validate_job_t> job_list_;
+        vector<void*> free_list_;
+        uint32_t pending_;
+        uint32_t in_place_pending_;
+        uint8_t fill_value_;
+        bool stop_;
+
+        vector<std::thread> worker_list_;
+        map<uint32_t, validate_result_t> result_map_;
+};
+
+#endif    // ROC_BANDWIDTH_TEST_VALIDATE_PIPELINE_HPP